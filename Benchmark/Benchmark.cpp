@@ -1,15 +1,33 @@
 #include <SimpleSTL/Types/SkipList.h>
+#include <SimpleSTL/Types/ConcurrentSkipList.h>
+#include <SimpleSTL/Types/ByteSkipList.h>
+#include <SimpleSTL/Types/IndexableSkipList.h>
+#include <SimpleSTL/Types/UnrolledSkipList.h>
+#include <SimpleSTL/Types/VersionedSkipList.h>
+#include <SimpleSTL/Types/MergingIterator.h>
+#include <SimpleSTL/Types/ShardedSkipList.h>
+#include <SimpleSTL/Memory/Arena.h>
+#include <SimpleSTL/Storage/SortedTable.h>
 #include <unordered_map>
 #include <map>
 
 #include <Keys.h>
+#include <Harness.h>
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <random>
 #include <cstddef>
 #include <chrono>
 #include <cassert>
+#include <iomanip>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
 
 inline uint64_t timestamp()
 {
@@ -17,6 +35,1744 @@ inline uint64_t timestamp()
 	return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
 }
 
+void benchmark25()
+{
+	Benchmark::Keys keys{};
+
+	const auto& kvs = keys.GetKeys();
+	const size_t total = kvs.size();
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 24;
+	constexpr int COL_TIME = 16;
+	constexpr int COL_OPS = 18;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Node Handle / Merge Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Path"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Moves/sec\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+
+	auto print_row = [&](const char* name, uint64_t ns, size_t moved)
+		{
+			std::cout << std::left << std::setw(COL_NAME) << name
+				<< std::right << std::setw(COL_TIME) << (ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << (moved / (ns / NS_PER_SEC))
+				<< "\n";
+		};
+
+	using List = SkipList<std::string, std::string>;
+
+	// even entries in one memtable, odd ones in the other
+	auto fill = [&](List& even, List& odd)
+		{
+			for (size_t i = 0; i < total; ++i)
+				(i % 2 ? odd : even).insert({ kvs[i].first, kvs[i].second });
+		};
+
+	{
+		List dst, src;
+		fill(dst, src);
+		const size_t moved = src.size();
+
+		auto t0 = timestamp();
+		for (auto& kv : src)
+			dst.insert({ kv.first, std::move(kv.second) });
+		src.clear();
+		auto t1 = timestamp();
+		print_row("insert + clear", t1 - t0, moved);
+	}
+
+	{
+		List dst, src;
+		fill(dst, src);
+		const size_t moved = src.size();
+
+		auto t0 = timestamp();
+		while (!src.empty())
+			dst.insert(src.extract(src.begin()));
+		auto t1 = timestamp();
+		print_row("extract + insert", t1 - t0, moved);
+	}
+
+	{
+		List dst, src;
+		fill(dst, src);
+		const size_t before = src.size();
+
+		auto t0 = timestamp();
+		dst.merge(src);
+		auto t1 = timestamp();
+		print_row("merge", t1 - t0, before - src.size());
+	}
+
+	{
+		// both memtables on one arena, so merge relinks; clearing the emptied
+		// source must leave the moved nodes alone, dst destroys them below
+		using ArenaList = SkipList<std::string, std::string, std::less<std::string>, ArenaAllocator<std::pair<const std::string, std::string>>>;
+
+		ArenaAllocator<std::pair<const std::string, std::string>> arena;
+		ArenaList dst(std::less<std::string>{}, arena), src(std::less<std::string>{}, arena);
+		for (size_t i = 0; i < total; ++i)
+			(i % 2 ? src : dst).insert({ kvs[i].first, kvs[i].second });
+		const size_t before = src.size();
+
+		auto t0 = timestamp();
+		dst.merge(src);
+		auto t1 = timestamp();
+		print_row("arena merge", t1 - t0, before - src.size());
+
+		src.clear();
+	}
+}
+
+void benchmark24()
+{
+	Benchmark::Keys keys{};
+
+	const auto& kvs = keys.GetKeys();
+
+	using List = SkipList<std::string, std::string>;
+	using ArenaList = SkipList<std::string, std::string, std::less<std::string>, ArenaAllocator<std::pair<const std::string, std::string>>>;
+
+	List source;
+	ArenaList arena_source;
+	for (const auto& kv : kvs)
+	{
+		source.insert({ kv.first, kv.second });
+		arena_source.insert({ kv.first, kv.second });
+	}
+
+	const size_t total = source.size();
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 24;
+	constexpr int COL_TIME = 16;
+	constexpr int COL_OPS = 18;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Copy / Clone Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Path"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Nodes/sec\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+
+	auto print_row = [&](const char* name, uint64_t ns)
+		{
+			std::cout << std::left << std::setw(COL_NAME) << name
+				<< std::right << std::setw(COL_TIME) << (ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << (total / (ns / NS_PER_SEC))
+				<< "\n";
+		};
+
+	{
+		// what the copy constructor used to do
+		auto t0 = timestamp();
+		List copy;
+		for (const auto& kv : source)
+			copy.insert(kv);
+		auto t1 = timestamp();
+		print_row("insert loop", t1 - t0);
+	}
+
+	{
+		auto t0 = timestamp();
+		List copy(source);
+		auto t1 = timestamp();
+		print_row("copy constructor", t1 - t0);
+		assert(copy.size() == total);
+	}
+
+	{
+		auto t0 = timestamp();
+		ArenaList copy(arena_source);
+		auto t1 = timestamp();
+		print_row("arena copy", t1 - t0);
+		assert(copy.size() == total);
+	}
+
+	{
+		auto t0 = timestamp();
+		ArenaList copy = arena_source.clone(ArenaAllocator<std::pair<const std::string, std::string>>(64 << 20));
+		auto t1 = timestamp();
+		print_row("arena clone (64 MB)", t1 - t0);
+		assert(copy.size() == total);
+	}
+}
+
+void benchmark23()
+{
+	Benchmark::Keys keys{};
+
+	const auto& kvs = keys.GetKeys();
+	const size_t total = kvs.size();
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 28;
+	constexpr int COL_TIME = 16;
+	constexpr int COL_OPS = 18;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Parallel Build / Teardown Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Path"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Ops/sec\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+
+	auto print_row = [&](const std::string& name, uint64_t ns)
+		{
+			std::cout << std::left << std::setw(COL_NAME) << name
+				<< std::right << std::setw(COL_TIME) << (ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << (total / (ns / NS_PER_SEC))
+				<< "\n";
+		};
+
+	using List = SkipList<std::string, std::string>;
+
+	{
+		List list;
+		auto t0 = timestamp();
+		for (const auto& kv : kvs)
+			list.insert({ kv.first, kv.second });
+		auto t1 = timestamp();
+		print_row("insert loop", t1 - t0);
+
+		t0 = timestamp();
+		list.clear();
+		t1 = timestamp();
+		print_row("clear", t1 - t0);
+	}
+
+	const unsigned max_threads = std::max(8u, std::thread::hardware_concurrency());
+	for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+	{
+		auto t0 = timestamp();
+		List list = List::from_unsorted(kvs.begin(), kvs.end(), threads);
+		auto t1 = timestamp();
+		print_row("parallel build x" + std::to_string(threads), t1 - t0);
+
+		assert(list.size() <= total);
+
+		t0 = timestamp();
+		list.clear_parallel(threads);
+		t1 = timestamp();
+		print_row("parallel clear x" + std::to_string(threads), t1 - t0);
+	}
+}
+
+void benchmark22()
+{
+	Benchmark::Keys keys{};
+
+	const auto& kvs = keys.GetKeys();
+	const size_t total = kvs.size();
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 10;
+	constexpr int COL_TIME = 18;
+	constexpr int COL_OPS = 18;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Sharded Scaling Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Shards"
+		<< std::left << std::setw(COL_NAME) << "Threads"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Ops/sec\n";
+
+	std::cout << std::string(2 * COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+
+	const unsigned max_threads = std::max(8u, std::thread::hardware_concurrency());
+	for (size_t shards : { 1, 4, 16, 64 })
+	{
+		for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+		{
+			// bounds come from a 1% sample, then the table is emptied again
+			ShardedSkipList<std::string, std::string> mem(shards);
+			for (size_t i = 0; i < total; i += 100)
+				mem.insert({ kvs[i].first, kvs[i].second });
+			mem.rebalance();
+			mem.clear();
+
+			// same split as the concurrent scaling benchmark: every thread
+			// inserts its slice, then looks up keys spread over the whole set
+			auto worker = [&](unsigned id)
+				{
+					const size_t begin = total * id / threads;
+					const size_t end = total * (id + 1) / threads;
+
+					for (size_t i = begin; i < end; ++i)
+						mem.insert({ kvs[i].first, kvs[i].second });
+
+					for (size_t i = begin; i < end; ++i)
+						mem.contains(kvs[(i * 7919) % total].first);
+				};
+
+			const auto t0 = timestamp();
+			std::vector<std::thread> pool;
+			pool.reserve(threads);
+			for (unsigned id = 0; id < threads; ++id)
+				pool.emplace_back(worker, id);
+			for (auto& t : pool)
+				t.join();
+			const auto t1 = timestamp();
+
+			assert(mem.size() <= total);
+
+			const auto ns = t1 - t0;
+			std::cout << std::left << std::setw(COL_NAME) << shards
+				<< std::left << std::setw(COL_NAME) << threads
+				<< std::right << std::setw(COL_TIME) << (ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << ((2.0 * total) / (ns / NS_PER_SEC))
+				<< "\n";
+		}
+	}
+}
+
+void benchmark21()
+{
+	Benchmark::Keys keys{};
+
+	const auto& kvs = keys.GetKeys();
+	const size_t total = kvs.size();
+
+	ConcurrentSkipList<std::string, std::string> mem;
+	for (const auto& kv : kvs)
+		mem.insert(kv);
+
+	constexpr auto RUN_FOR = std::chrono::milliseconds(1000);
+	constexpr size_t SCAN_LENGTH = 16;
+
+	constexpr int COL_NAME = 20;
+	constexpr int COL_OPS = 18;
+	constexpr int COL_RETIRED = 12;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Concurrent Erase Stress Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Readers/Writers"
+		<< std::right << std::setw(COL_OPS) << "Reads/sec"
+		<< std::right << std::setw(COL_OPS) << "Writes/sec"
+		<< std::right << std::setw(COL_RETIRED) << "Retired\n";
+
+	std::cout << std::string(COL_NAME + 2 * COL_OPS + COL_RETIRED, '-') << "\n";
+
+	const std::array<std::pair<unsigned, unsigned>, 4> configs{ { { 2, 0 }, { 2, 1 }, { 2, 2 }, { 4, 2 } } };
+	for (const auto& [readers, writers] : configs)
+	{
+		std::atomic<bool> stop{ false };
+		std::atomic<uint64_t> reads{ 0 };
+		std::atomic<uint64_t> writes{ 0 };
+
+		// readers mix point lookups with short scans that hold a pin across
+		// the iteration, writers erase a random key and put it back
+		auto reader = [&](unsigned id)
+			{
+				std::mt19937 rng(id);
+				uint64_t done = 0;
+				size_t bytes = 0;
+				while (!stop.load(std::memory_order_relaxed))
+				{
+					const auto& key = kvs[rng() % total].first;
+					if (done % 8 == 0)
+					{
+						auto guard = mem.pin();
+						size_t n = 0;
+						for (auto it = mem.lower_bound(key); it != mem.end() && n < SCAN_LENGTH; ++it, ++n)
+							bytes += it->second.size();
+					}
+					else
+					{
+						auto guard = mem.pin();
+						auto it = mem.find(key);
+						if (it != mem.end())
+							bytes += it->second.size();
+					}
+					++done;
+				}
+				assert(bytes != 0 || done == 0);
+				reads.fetch_add(done, std::memory_order_relaxed);
+			};
+
+		auto writer = [&](unsigned id)
+			{
+				std::mt19937 rng(1000 + id);
+				uint64_t done = 0;
+				while (!stop.load(std::memory_order_relaxed))
+				{
+					const auto& kv = kvs[rng() % total];
+					++done;
+					if (mem.erase(kv.first))
+					{
+						mem.insert(kv);
+						++done;
+					}
+				}
+				writes.fetch_add(done, std::memory_order_relaxed);
+			};
+
+		std::vector<std::thread> pool;
+		for (unsigned id = 0; id < readers; ++id)
+			pool.emplace_back(reader, id);
+		for (unsigned id = 0; id < writers; ++id)
+			pool.emplace_back(writer, id);
+
+		const auto t0 = timestamp();
+		std::this_thread::sleep_for(RUN_FOR);
+		stop.store(true, std::memory_order_relaxed);
+		for (auto& t : pool)
+			t.join();
+		const auto t1 = timestamp();
+
+		assert(mem.size() <= total);
+
+		const double secs = (t1 - t0) / 1e9;
+		const std::string name = std::to_string(readers) + "/" + std::to_string(writers);
+		std::cout << std::left << std::setw(COL_NAME) << name
+			<< std::right << std::setw(COL_OPS) << (reads.load() / secs)
+			<< std::right << std::setw(COL_OPS) << (writes.load() / secs)
+			<< std::right << std::setw(COL_RETIRED) << mem.retired_count()
+			<< "\n";
+	}
+}
+
+using MemTable = SkipList<std::string, std::string>;
+
+// the hand written merge: every step scans all heads for the smallest key
+static size_t merge_linear(const std::vector<const MemTable*>& tables, std::vector<MemTable::const_iterator>& heads, const std::string* from, size_t limit)
+{
+	for (size_t i = 0; i < tables.size(); ++i)
+		heads[i] = from ? tables[i]->lower_bound(*from) : tables[i]->begin();
+
+	size_t bytes = 0;
+	for (size_t n = 0; n < limit; ++n)
+	{
+		size_t best = tables.size();
+		for (size_t i = 0; i < tables.size(); ++i)
+		{
+			if (heads[i] != tables[i]->end() && (best == tables.size() || heads[i]->first < heads[best]->first))
+				best = i;
+		}
+
+		if (best == tables.size())
+			break;
+
+		const std::string& key = heads[best]->first;
+		bytes += heads[best]->second.size();
+		for (size_t i = best + 1; i < tables.size(); ++i)
+		{
+			if (heads[i] != tables[i]->end() && heads[i]->first == key)
+				++heads[i];
+		}
+		++heads[best];
+	}
+
+	return bytes;
+}
+
+static size_t merge_tree(MergingIterator<MemTable>& it, const std::string* from, size_t limit)
+{
+	if (from)
+		it.seek(*from);
+	else
+		it.seek_to_first();
+
+	size_t bytes = 0;
+	for (size_t n = 0; n < limit && it.valid(); ++n, it.next())
+		bytes += it.value().size();
+
+	return bytes;
+}
+
+void benchmark20()
+{
+	Benchmark::Keys keys{};
+
+	constexpr int SEEKS = 20'000;
+	constexpr size_t SCAN_LENGTH = 50;
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 28;
+	constexpr int COL_TIME = 18;
+	constexpr int COL_OPS = 18;
+	constexpr int COL_BYTES = 16;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Merging Iterator Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Operation"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Ops/sec"
+		<< std::right << std::setw(COL_BYTES) << "Value bytes\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS + COL_BYTES, '-') << "\n";
+
+	// the byte count keeps the merged values alive and shows both merges
+	// returned the same data
+	auto print_row = [&](const std::string& name, double time_ns, double ops, size_t bytes)
+		{
+			std::cout << std::left << std::setw(COL_NAME) << name
+				<< std::right << std::setw(COL_TIME) << (time_ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << (ops / (time_ns / NS_PER_SEC))
+				<< std::right << std::setw(COL_BYTES) << bytes
+				<< "\n";
+		};
+
+	for (size_t sources : { 2, 4, 8, 16 })
+	{
+		// round robin over the memtables, every 8th key also lands in the
+		// next older one so the merge has duplicates to drop
+		std::vector<MemTable> tables(sources);
+		const auto& kvs = keys.GetKeys();
+		for (size_t i = 0; i < kvs.size(); ++i)
+		{
+			tables[i % sources].insert(kvs[i]);
+			if (i % 8 == 0)
+				tables[(i + 1) % sources].insert(kvs[i]);
+		}
+
+		std::vector<const MemTable*> ptrs;
+		for (const MemTable& t : tables)
+			ptrs.push_back(&t);
+
+		std::vector<MemTable::const_iterator> heads(sources);
+		MergingIterator<MemTable> merged(ptrs);
+
+		const auto t0 = timestamp();
+		const size_t linear_bytes = merge_linear(ptrs, heads, nullptr, SIZE_MAX);
+		const auto t1 = timestamp();
+		const size_t tree_bytes = merge_tree(merged, nullptr, SIZE_MAX);
+		const auto t2 = timestamp();
+		assert(linear_bytes == tree_bytes);
+
+		size_t linear_seek_bytes = 0;
+		const auto t3 = timestamp();
+		for (int i = 0; i < SEEKS; ++i)
+			linear_seek_bytes += merge_linear(ptrs, heads, &keys.PickRandomKey(), SCAN_LENGTH);
+		const auto t4 = timestamp();
+		size_t tree_seek_bytes = 0;
+		for (int i = 0; i < SEEKS; ++i)
+			tree_seek_bytes += merge_tree(merged, &keys.PickRandomKey(), SCAN_LENGTH);
+		const auto t5 = timestamp();
+		assert(linear_seek_bytes != 0 && tree_seek_bytes != 0);
+
+		const std::string n = " (N=" + std::to_string(sources) + ")";
+		print_row("Scan Linear" + n, t1 - t0, (double)kvs.size(), linear_bytes);
+		print_row("Scan Loser Tree" + n, t2 - t1, (double)kvs.size(), tree_bytes);
+		print_row("Seek+50 Linear" + n, t4 - t3, SEEKS, linear_seek_bytes);
+		print_row("Seek+50 Loser Tree" + n, t5 - t4, SEEKS, tree_seek_bytes);
+	}
+}
+
+void benchmark19()
+{
+	Benchmark::Keys keys{};
+
+	SkipList<std::string, std::string> mem;
+	for (const auto& [key, value] : keys.GetKeys())
+		mem.insert({ key, value });
+
+	const auto dir = std::filesystem::temp_directory_path();
+	const std::string stream_path = (dir / "simplestl_bench19.dat").string();
+	const std::string table_path = (dir / "simplestl_bench19.sst").string();
+
+	constexpr int FINDS = 1'000'000;
+
+	// the old path: length prefixed records, one key at a time through iostreams
+	const auto t0 = timestamp();
+	{
+		std::ofstream out(stream_path, std::ios::binary);
+		for (const auto& [key, value] : mem)
+		{
+			const uint32_t key_size = (uint32_t)key.size();
+			const uint32_t value_size = (uint32_t)value.size();
+			out.write(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+			out.write(key.data(), key_size);
+			out.write(reinterpret_cast<const char*>(&value_size), sizeof(value_size));
+			out.write(value.data(), value_size);
+		}
+	}
+	const auto t1 = timestamp();
+
+	const auto t2 = timestamp();
+	write_sorted_table(mem, table_path);
+	const auto t3 = timestamp();
+
+	// reopen: rebuild the memtable from the stream vs map the table
+	const auto t4 = timestamp();
+	SkipList<std::string, std::string> loaded;
+	{
+		std::ifstream in(stream_path, std::ios::binary);
+		uint32_t key_size = 0, value_size = 0;
+		std::string key, value;
+		while (in.read(reinterpret_cast<char*>(&key_size), sizeof(key_size)))
+		{
+			key.resize(key_size);
+			in.read(key.data(), key_size);
+			in.read(reinterpret_cast<char*>(&value_size), sizeof(value_size));
+			value.resize(value_size);
+			in.read(value.data(), value_size);
+			loaded.insert({ key, value });
+		}
+	}
+	const auto t5 = timestamp();
+
+	const auto t6 = timestamp();
+	SortedTable table(table_path);
+	const auto t7 = timestamp();
+	assert(loaded.size() == mem.size() && table.size() == mem.size());
+
+	size_t found = 0;
+	const auto t8 = timestamp();
+	for (int i = 0; i < FINDS; ++i)
+		found += loaded.find(keys.PickRandomKey()) != loaded.end();
+	const auto t9 = timestamp();
+
+	const auto t10 = timestamp();
+	for (int i = 0; i < FINDS; ++i)
+		found += table.find(keys.PickRandomKey()) != table.end();
+	const auto t11 = timestamp();
+
+	size_t bytes = 0;
+	const auto t12 = timestamp();
+	for (const auto& [key, value] : table)
+		bytes += key.size() + value.size();
+	const auto t13 = timestamp();
+	assert(found == 2 * (size_t)FINDS && bytes != 0);
+
+	const auto stream_bytes = std::filesystem::file_size(stream_path);
+	const auto table_bytes = table.file_size();
+	table = SortedTable();
+	std::filesystem::remove(stream_path);
+	std::filesystem::remove(table_path);
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 28;
+	constexpr int COL_TIME = 18;
+	constexpr int COL_OPS = 18;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Flush / Reopen Benchmark ===\n";
+	std::cout << "Stream file: " << stream_bytes << " bytes, table file: " << table_bytes << " bytes\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Operation"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Ops/sec\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+
+	auto print_row = [&](const char* name, double time_ns, double ops)
+		{
+			std::cout << std::left << std::setw(COL_NAME) << name
+				<< std::right << std::setw(COL_TIME) << (time_ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << (ops / (time_ns / NS_PER_SEC))
+				<< "\n";
+		};
+
+	print_row("Flush (ofstream)", t1 - t0, (double)mem.size());
+	print_row("Flush (SortedTable)", t3 - t2, (double)mem.size());
+	print_row("Reopen (ifstream)", t5 - t4, (double)mem.size());
+	print_row("Reopen (SortedTable)", t7 - t6, (double)mem.size());
+	print_row("Find (reloaded SkipList)", t9 - t8, FINDS);
+	print_row("Find (SortedTable)", t11 - t10, FINDS);
+	print_row("Scan (SortedTable)", t13 - t12, (double)mem.size());
+}
+
+void benchmark18()
+{
+	Benchmark::Keys keys{};
+
+	SkipList<std::string, std::string>				mem;
+	VersionedSkipList<std::string, std::string>		mem2;
+	for (const auto& [key, value] : keys.GetKeys())
+	{
+		mem.insert({ key, value });
+		mem2.insert_or_assign(key, value);
+	}
+
+	constexpr int SNAPSHOTS = 100'000;
+
+	// what a point in time read costs today: a full copy
+	const auto t0 = timestamp();
+	SkipList<std::string, std::string> copy(mem);
+	const auto t1 = timestamp();
+	assert(copy.size() == mem.size());
+
+	size_t found = 0;
+	const auto t2 = timestamp();
+	for (int i = 0; i < SNAPSHOTS; ++i)
+	{
+		const auto snap = mem2.snapshot();
+		found += snap.contains(keys.PickRandomKey());
+	}
+	const auto t3 = timestamp();
+
+	// reads at a fixed snapshot while a writer keeps overwriting values
+	std::atomic<bool> stop{ false };
+	std::thread writer([&]
+		{
+			size_t i = 0;
+			while (!stop.load(std::memory_order_relaxed))
+			{
+				const auto& [key, value] = keys.GetKeys()[i++ % keys.GetKeys().size()];
+				mem2.insert_or_assign(key, value);
+			}
+		});
+
+	const auto snap = mem2.snapshot();
+	const auto t4 = timestamp();
+	for (int i = 0; i < SNAPSHOTS; ++i)
+		found += snap.contains(keys.PickRandomKey());
+	const auto t5 = timestamp();
+
+	stop.store(true, std::memory_order_relaxed);
+	writer.join();
+	assert(found != 0);
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 28;
+	constexpr int COL_TIME = 18;
+	constexpr int COL_OPS = 18;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Snapshot Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Operation"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Ops/sec\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+
+	auto print_row = [&](const char* name, double time_ns, double ops)
+		{
+			std::cout << std::left << std::setw(COL_NAME) << name
+				<< std::right << std::setw(COL_TIME) << (time_ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << (ops / (time_ns / NS_PER_SEC))
+				<< "\n";
+		};
+
+	print_row("SkipList Copy", t1 - t0, 1);
+	print_row("Snapshot + Find", t3 - t2, SNAPSHOTS);
+	print_row("Snapshot Find (writing)", t5 - t4, SNAPSHOTS);
+}
+
+template<class List>
+static void print_stats_row(const char* name, const List& list, int col_name)
+{
+	const auto s = list.stats();
+
+	std::cout << std::left << std::setw(col_name) << name
+		<< std::right << std::setw(12) << s.size
+		<< std::right << std::setw(16) << s.node_bytes
+		<< std::right << std::setw(8) << (int)s.level
+		<< std::right << std::setw(12) << s.average_height
+		<< std::right << std::setw(14) << s.expected_search_path
+		<< "\n";
+}
+
+void benchmark17()
+{
+	Benchmark::Keys keys{};
+
+	using Quarter = SkipList<std::string, std::string>;
+	using Half = SkipList<std::string, std::string, std::less<std::string>,
+		std::allocator<std::pair<const std::string, std::string>>, 20, 1, 2>;
+	using Short = SkipList<std::string, std::string, std::less<std::string>,
+		std::allocator<std::pair<const std::string, std::string>>, 4, 1, 4>;
+
+	Quarter mem;
+	Half mem2;
+	Short mem3;
+	for (const auto& [key, value] : keys.GetKeys())
+	{
+		mem.insert({ key, value });
+		mem2.insert({ key, value });
+		mem3.insert({ key, value });
+	}
+
+	constexpr int CALLS = 1'000'000;
+
+	size_t sink = 0;
+	const auto t0 = timestamp();
+	for (int i = 0; i < CALLS; ++i)
+		sink += mem.stats().node_bytes;
+	const auto t1 = timestamp();
+	assert(sink != 0);
+
+	constexpr int COL_NAME = 20;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Structure Stats ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Structure"
+		<< std::right << std::setw(12) << "Size"
+		<< std::right << std::setw(16) << "Node Bytes"
+		<< std::right << std::setw(8) << "Level"
+		<< std::right << std::setw(12) << "Avg Height"
+		<< std::right << std::setw(14) << "Search Path\n";
+
+	std::cout << std::string(COL_NAME + 12 + 16 + 8 + 12 + 14, '-') << "\n";
+
+	print_stats_row("P=1/4 MaxLevel=12", mem, COL_NAME);
+	print_stats_row("P=1/2 MaxLevel=20", mem2, COL_NAME);
+	print_stats_row("P=1/4 MaxLevel=4", mem3, COL_NAME);
+
+	std::cout << "\nstats() cost: " << ((t1 - t0) / (double)CALLS) << " ns/call\n";
+}
+
+template<class Policy>
+static double bench_height_policy(const Benchmark::Keys& keys)
+{
+	using List = SkipList<std::string, std::string, std::less<std::string>,
+		std::allocator<std::pair<const std::string, std::string>>, 12, 1, 4, Policy>;
+
+	List mem;
+
+	const auto t0 = timestamp();
+	for (const auto& kv : keys.GetKeys())
+		mem.insert(kv);
+	const auto t1 = timestamp();
+
+	assert(mem.size() == keys.GetKeys().size());
+	return (double)(t1 - t0);
+}
+
+template<class Policy>
+static double bench_height_draws(std::array<size_t, 12>& hist, int draws)
+{
+	Policy policy;
+	hist.fill(0);
+
+	const std::string key = "height";
+	const auto t0 = timestamp();
+	for (int i = 0; i < draws; ++i)
+		++hist[policy.template height<12, 1, 4>(key) - 1];
+	const auto t1 = timestamp();
+
+	return (double)(t1 - t0);
+}
+
+void benchmark15()
+{
+	Benchmark::Keys keys{};
+
+	constexpr int DRAWS = 1 << 22;
+
+	std::array<size_t, 12> hist_mt{};
+	std::array<size_t, 12> hist_xs{};
+	std::array<size_t, 12> hist_seed{};
+
+	const double insert_mt = bench_height_policy<MersenneHeight>(keys);
+	const double insert_xs = bench_height_policy<XorShiftHeight>(keys);
+	const double insert_seed = bench_height_policy<SeededHeight<>>(keys);
+	const double insert_hash = bench_height_policy<KeyHashHeight<>>(keys);
+
+	const double draw_mt = bench_height_draws<MersenneHeight>(hist_mt, DRAWS);
+	const double draw_xs = bench_height_draws<XorShiftHeight>(hist_xs, DRAWS);
+	const double draw_seed = bench_height_draws<SeededHeight<>>(hist_seed, DRAWS);
+
+	// key hash heights are drawn over the real keys, one draw per key
+	std::array<size_t, 12> hist_hash{};
+	KeyHashHeight<> hash_policy;
+	for (const auto& kv : keys.GetKeys())
+		++hist_hash[hash_policy.height<12, 1, 4>(kv.first) - 1];
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 28;
+	constexpr int COL_TIME = 18;
+	constexpr int COL_OPS = 18;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Height Policy Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Operation"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Ops/sec\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+
+	auto print_row = [&](const char* name, double time_ns, double ops)
+		{
+			std::cout << std::left << std::setw(COL_NAME) << name
+				<< std::right << std::setw(COL_TIME) << (time_ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << (ops / (time_ns / NS_PER_SEC))
+				<< "\n";
+		};
+
+	const double n = (double)keys.GetKeys().size();
+	print_row("Insert Mersenne", insert_mt, n);
+	print_row("Insert XorShift", insert_xs, n);
+	print_row("Insert Seeded", insert_seed, n);
+	print_row("Insert KeyHash", insert_hash, n);
+	print_row("Height Mersenne", draw_mt, DRAWS);
+	print_row("Height XorShift", draw_xs, DRAWS);
+	print_row("Height Seeded", draw_seed, DRAWS);
+
+	// fraction of towers per height, expected (1 - p) * p^(h - 1) with p = 1/4
+	std::cout << "\n" << std::left << std::setw(8) << "Height"
+		<< std::right << std::setw(12) << "Expected"
+		<< std::right << std::setw(12) << "Mersenne"
+		<< std::right << std::setw(12) << "XorShift"
+		<< std::right << std::setw(12) << "Seeded"
+		<< std::right << std::setw(12) << "KeyHash" << "\n";
+
+	std::cout << std::setprecision(5);
+	double expected = 0.75;
+	for (size_t h = 0; h < 8; ++h)
+	{
+		std::cout << std::left << std::setw(8) << (h + 1)
+			<< std::right << std::setw(12) << expected
+			<< std::right << std::setw(12) << (double)hist_mt[h] / DRAWS
+			<< std::right << std::setw(12) << (double)hist_xs[h] / DRAWS
+			<< std::right << std::setw(12) << (double)hist_seed[h] / DRAWS
+			<< std::right << std::setw(12) << (double)hist_hash[h] / n << "\n";
+		expected /= 4;
+	}
+	std::cout << std::setprecision(3);
+}
+
+void benchmark14()
+{
+	Benchmark::Keys keys{};
+
+	using List = SkipList<std::string, std::string>;
+
+	// start half full so the upserts below mix hits and misses
+	List mem;
+	List mem2;
+	for (size_t i = 0; i < keys.GetKeys().size(); i += 2)
+	{
+		mem.insert({ keys.GetKeys()[i].first, keys.GetKeys()[i].second });
+		mem2.insert({ keys.GetKeys()[i].first, keys.GetKeys()[i].second });
+	}
+
+	std::vector<std::pair<std::string, std::string>> upserts;
+	upserts.reserve(keys.GetNumOfKeys());
+	for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
+		upserts.push_back(keys.GetKeys()[(i * 7919ull) % keys.GetNumOfKeys()]);
+
+	// what insert_or_assign used to do: find, then insert a pair temporary
+	const auto t0 = timestamp();
+	for (const auto& [key, value] : upserts)
+	{
+		auto it = mem.find(key);
+		if (it != mem.end())
+			it->second = value;
+		else
+			mem.insert(List::value_type{ key, value });
+	}
+	const auto t1 = timestamp();
+
+	const auto t2 = timestamp();
+	for (const auto& [key, value] : upserts)
+		mem2.insert_or_assign(key, value);
+	const auto t3 = timestamp();
+
+	List mem3;
+	List mem4;
+
+	const auto t4 = timestamp();
+	for (const auto& [key, value] : upserts)
+		mem3.insert(List::value_type{ key, value });
+	const auto t5 = timestamp();
+
+	const auto t6 = timestamp();
+	for (const auto& [key, value] : upserts)
+		mem4.try_emplace(key, value);
+	const auto t7 = timestamp();
+
+	assert(mem.size() == mem2.size() && mem3.size() == mem4.size());
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 28;
+	constexpr int COL_TIME = 18;
+	constexpr int COL_OPS = 18;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Upsert Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Operation"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Ops/sec\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+
+	auto print_row = [&](const char* name, double time_ns)
+		{
+			std::cout << std::left << std::setw(COL_NAME) << name
+				<< std::right << std::setw(COL_TIME) << (time_ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << (upserts.size() / (time_ns / NS_PER_SEC))
+				<< "\n";
+		};
+
+	print_row("find + insert", t1 - t0);
+	print_row("insert_or_assign", t3 - t2);
+	print_row("insert(value_type)", t5 - t4);
+	print_row("try_emplace", t7 - t6);
+}
+
+void benchmark13()
+{
+	Benchmark::Keys keys{};
+
+	SkipList<std::string, std::string>					mem;
+	SkipList<std::string, std::string, std::less<>>		mem2;
+
+	for (const auto& [key, value] : keys.GetKeys())
+	{
+		mem.insert({ key, value });
+		mem2.insert({ key, value });
+	}
+
+	// request handlers only hold views of the key bytes
+	std::vector<std::string_view> lookups;
+	lookups.reserve(keys.GetNumOfKeys());
+	for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
+		lookups.push_back(keys.PickRandomKey());
+
+	size_t found = 0;
+	const auto t0 = timestamp();
+	for (const auto key : lookups)
+		found += mem.find(std::string(key)) != mem.end();
+	const auto t1 = timestamp();
+
+	const auto t2 = timestamp();
+	for (const auto key : lookups)
+		found += mem2.find(key) != mem2.end();
+	const auto t3 = timestamp();
+	assert(found == 2 * lookups.size());
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 28;
+	constexpr int COL_TIME = 18;
+	constexpr int COL_OPS = 18;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Heterogeneous Lookup Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Operation"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Ops/sec\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+
+	auto print_row = [&](const char* name, double time_ns)
+		{
+			std::cout << std::left << std::setw(COL_NAME) << name
+				<< std::right << std::setw(COL_TIME) << (time_ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << (lookups.size() / (time_ns / NS_PER_SEC))
+				<< "\n";
+		};
+
+	print_row("Find (std::string temp)", t1 - t0);
+	print_row("Find (string_view)", t3 - t2);
+}
+
+void benchmark12()
+{
+	Benchmark::Keys keys{};
+
+	SkipList<std::string, std::string>				mem;
+	IndexableSkipList<std::string, std::string>		mem2;
+
+	const auto t0 = timestamp();
+	for (const auto& [key, value] : keys.GetKeys())
+		mem.insert({ key, value });
+	const auto t1 = timestamp();
+
+	const auto t2 = timestamp();
+	for (const auto& [key, value] : keys.GetKeys())
+		mem2.insert({ key, value });
+	const auto t3 = timestamp();
+
+	// "entries p..p+100" pages at spread out offsets
+	constexpr size_t PAGES = 200;
+	constexpr size_t PAGE_SIZE = 100;
+	const size_t span = mem.size() - PAGE_SIZE;
+
+	size_t sink = 0;
+	const auto t4 = timestamp();
+	for (size_t p = 0; p < PAGES; ++p)
+	{
+		auto it = mem.begin();
+		std::advance(it, span * p / PAGES);
+		for (size_t i = 0; i < PAGE_SIZE; ++i, ++it)
+			sink += it->second.size();
+	}
+	const auto t5 = timestamp();
+
+	// pages are served from a read-only view, like a reader holding const&
+	const auto& view = mem2;
+
+	const auto t6 = timestamp();
+	for (size_t p = 0; p < PAGES; ++p)
+	{
+		auto it = view.nth(span * p / PAGES);
+		for (size_t i = 0; i < PAGE_SIZE; ++i, ++it)
+			sink += it->second.size();
+	}
+	const auto t7 = timestamp();
+
+	for (size_t p = 0; p < PAGES; ++p)
+	{
+		const auto& key = view.nth(span * p / PAGES)->first;
+		sink += view.contains(key) + (view.find(key) == view.lower_bound(key));
+	}
+
+	const auto t8 = timestamp();
+	for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
+		sink += mem2.rank(keys.PickRandomKey());
+	const auto t9 = timestamp();
+
+	assert(sink > 0);
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 28;
+	constexpr int COL_TIME = 18;
+	constexpr int COL_OPS = 18;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Indexable SkipList Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Operation"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Ops/sec\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+
+	auto print_row = [&](const char* name, double time_ns, double ops)
+		{
+			std::cout << std::left << std::setw(COL_NAME) << name
+				<< std::right << std::setw(COL_TIME) << (time_ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << (ops / (time_ns / NS_PER_SEC))
+				<< "\n";
+		};
+
+	print_row("SkipList Insert", t1 - t0, keys.GetNumOfKeys());
+	print_row("Indexable Insert", t3 - t2, keys.GetNumOfKeys());
+	print_row("SkipList Page (advance)", t5 - t4, PAGES);
+	print_row("Indexable Page (nth)", t7 - t6, PAGES);
+	print_row("Indexable rank", t9 - t8, keys.GetNumOfKeys());
+}
+
+void benchmark11()
+{
+	Benchmark::Keys keys{};
+
+	using List = SkipList<std::string, std::string>;
+
+	auto sorted = keys.GetKeys();
+	std::sort(sorted.begin(), sorted.end());
+
+	constexpr size_t RUN = 1000;
+	constexpr size_t STRIDE = 4 * RUN;
+
+	List mem = List::from_sorted(sorted.begin(), sorted.end());
+	List mem2 = List::from_sorted(sorted.begin(), sorted.end());
+
+	size_t scanned = 0;
+	const auto t0 = timestamp();
+	for (size_t i = 0; i + RUN < sorted.size(); i += STRIDE)
+	{
+		for (const auto& [key, value] : mem.range(sorted[i].first, sorted[i + RUN].first))
+			scanned += value.size();
+	}
+	const auto t1 = timestamp();
+
+	size_t erased = 0;
+	const auto t2 = timestamp();
+	for (size_t i = 0; i + RUN < sorted.size(); i += STRIDE)
+		erased += mem.erase(sorted[i].first, sorted[i + RUN].first);
+	const auto t3 = timestamp();
+
+	const auto t4 = timestamp();
+	for (size_t i = 0; i + RUN < sorted.size(); i += STRIDE)
+	{
+		for (size_t j = i; j < i + RUN; ++j)
+			mem2.erase(sorted[j].first);
+	}
+	const auto t5 = timestamp();
+
+	assert(mem.size() == mem2.size());
+	assert(scanned > 0);
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 28;
+	constexpr int COL_TIME = 18;
+	constexpr int COL_OPS = 18;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Range Operations Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Operation"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Entries/sec\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+
+	auto print_row = [&](const char* name, double time_ns)
+		{
+			std::cout << std::left << std::setw(COL_NAME) << name
+				<< std::right << std::setw(COL_TIME) << (time_ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << (erased / (time_ns / NS_PER_SEC))
+				<< "\n";
+		};
+
+	print_row("Range Scan", t1 - t0);
+	print_row("Range Erase", t3 - t2);
+	print_row("Per-key Erase", t5 - t4);
+}
+
+void benchmark10()
+{
+	Benchmark::Keys keys{};
+
+	using List = SkipList<std::string, std::string>;
+
+	List mem;
+	for (const auto& [key, value] : keys.GetKeys())
+		mem.insert({ key, value });
+
+	std::vector<std::string> lookups;
+	lookups.reserve(keys.GetNumOfKeys());
+	for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
+		lookups.push_back(keys.PickRandomKey());
+
+	constexpr size_t BATCH = 32;
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 28;
+	constexpr int COL_TIME = 18;
+	constexpr int COL_OPS = 18;
+
+	size_t found = 0;
+	const auto t0 = timestamp();
+	for (const auto& key : lookups)
+		found += mem.find(key) != mem.end();
+	const auto t1 = timestamp();
+	assert(found == lookups.size());
+
+	std::array<List::iterator, BATCH> out{};
+	const auto t2 = timestamp();
+	for (size_t i = 0; i < lookups.size(); i += BATCH)
+	{
+		const size_t n = std::min(BATCH, lookups.size() - i);
+		mem.multi_find(std::span<const std::string>(lookups.data() + i, n), out);
+		assert(out[0] != mem.end());
+	}
+	const auto t3 = timestamp();
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Batched Lookup Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Operation"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Ops/sec\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+
+	auto print_row = [&](const char* name, double time_ns)
+		{
+			std::cout << std::left << std::setw(COL_NAME) << name
+				<< std::right << std::setw(COL_TIME) << (time_ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << (lookups.size() / (time_ns / NS_PER_SEC))
+				<< "\n";
+		};
+
+	print_row("Single find", t1 - t0);
+	print_row("multi_find (32)", t3 - t2);
+}
+
+void benchmark9()
+{
+	Benchmark::Keys keys{};
+
+	using List = SkipList<std::string, std::string>;
+
+	auto sorted = keys.GetKeys();
+	std::sort(sorted.begin(), sorted.end());
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 28;
+	constexpr int COL_TIME = 18;
+	constexpr int COL_OPS = 18;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Bulk Load Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Operation"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Ops/sec\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+
+	auto print_row = [&](const char* name, double time_ns)
+		{
+			std::cout << std::left << std::setw(COL_NAME) << name
+				<< std::right << std::setw(COL_TIME) << (time_ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << (keys.GetNumOfKeys() / (time_ns / NS_PER_SEC))
+				<< "\n";
+		};
+
+	auto time_find = [&](const List& mem)
+		{
+			size_t found = 0;
+			const auto t0 = timestamp();
+			for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
+				found += mem.find(keys.PickRandomKey()) != mem.end();
+			const auto t1 = timestamp();
+			assert(found == keys.GetNumOfKeys());
+			return t1 - t0;
+		};
+
+	{
+		List mem;
+
+		const auto t0 = timestamp();
+		for (const auto& [key, value] : sorted)
+			mem.insert({ key, value });
+		const auto t1 = timestamp();
+
+		print_row("Insert Loop", t1 - t0);
+		print_row("Insert Loop Find", time_find(mem));
+	}
+
+	{
+		const auto t0 = timestamp();
+		List mem = List::from_sorted(sorted.begin(), sorted.end());
+		const auto t1 = timestamp();
+
+		print_row("from_sorted", t1 - t0);
+		print_row("from_sorted Find", time_find(mem));
+	}
+
+	{
+		const auto t0 = timestamp();
+		List mem = List::from_sorted(sorted.begin(), sorted.end(), true);
+		const auto t1 = timestamp();
+
+		print_row("from_sorted Balanced", t1 - t0);
+		print_row("from_sorted Balanced Find", time_find(mem));
+	}
+}
+
+void benchmark8()
+{
+	Benchmark::Keys keys{};
+
+	using List = SkipList<std::string, std::string>;
+
+	// sorted and near-sorted (shuffled inside small windows) ingest orders
+	auto sorted = keys.GetKeys();
+	std::sort(sorted.begin(), sorted.end());
+
+	auto near_sorted = sorted;
+	std::mt19937 gen(std::random_device{}());
+	constexpr size_t WINDOW = 16;
+	for (size_t i = 0; i + WINDOW <= near_sorted.size(); i += WINDOW)
+		std::shuffle(near_sorted.begin() + i, near_sorted.begin() + i + WINDOW, gen);
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 28;
+	constexpr int COL_TIME = 18;
+	constexpr int COL_OPS = 18;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Finger Search Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Operation"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Ops/sec\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+
+	auto print_row = [&](const char* name, double time_ns)
+		{
+			std::cout << std::left << std::setw(COL_NAME) << name
+				<< std::right << std::setw(COL_TIME) << (time_ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << (keys.GetNumOfKeys() / (time_ns / NS_PER_SEC))
+				<< "\n";
+		};
+
+	auto ingest = [&](const char* name, const auto& input, bool use_finger)
+		{
+			List mem;
+			List::finger f;
+
+			const auto t0 = timestamp();
+			if (use_finger)
+			{
+				for (const auto& [key, value] : input)
+					mem.insert(f, { key, value });
+			}
+			else
+			{
+				for (const auto& [key, value] : input)
+					mem.insert({ key, value });
+			}
+			const auto t1 = timestamp();
+
+			print_row(name, t1 - t0);
+			return mem;
+		};
+
+	ingest("Sorted Insert", sorted, false);
+	ingest("Sorted Insert (finger)", sorted, true);
+	ingest("Near-sorted Insert", near_sorted, false);
+	List mem = ingest("Near-sorted Insert (finger)", near_sorted, true);
+
+	size_t found = 0;
+	const auto t0 = timestamp();
+	for (const auto& kv : near_sorted)
+		found += mem.find(kv.first) != mem.end();
+	const auto t1 = timestamp();
+
+	List::finger f;
+	const auto t2 = timestamp();
+	for (const auto& kv : near_sorted)
+		found += mem.find(f, kv.first) != mem.end();
+	const auto t3 = timestamp();
+	assert(found == 2 * near_sorted.size());
+
+	print_row("Near-sorted Find", t1 - t0);
+	print_row("Near-sorted Find (finger)", t3 - t2);
+}
+
+// std::allocator that tallies the bytes currently handed out, used to compare
+// node memory against the arena.
+inline size_t g_counted_bytes = 0;
+
+template<class T>
+struct CountingAllocator : std::allocator<T>
+{
+	template<class U>
+	struct rebind { using other = CountingAllocator<U>; };
+
+	CountingAllocator() = default;
+
+	template<class U>
+	CountingAllocator(const CountingAllocator<U>&) noexcept { }
+
+	T* allocate(size_t n)
+	{
+		g_counted_bytes += n * sizeof(T);
+		return std::allocator<T>::allocate(n);
+	}
+
+	void deallocate(T* p, size_t n) noexcept
+	{
+		g_counted_bytes -= n * sizeof(T);
+		std::allocator<T>::deallocate(p, n);
+	}
+};
+
+void benchmark7()
+{
+	Benchmark::Keys keys{};
+
+	using StringList = SkipList<std::string, std::string, std::less<std::string>, CountingAllocator<std::pair<const std::string, std::string>>>;
+	using InlineList = ByteSkipList<std::less<std::string_view>, CountingAllocator<std::byte>>;
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 24;
+	constexpr int COL_TIME = 16;
+	constexpr int COL_OPS = 18;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Inline Key/Value Storage Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Operation"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Ops/sec\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+
+	auto print_row = [&](const char* name, double time_ns)
+		{
+			std::cout << std::left << std::setw(COL_NAME) << name
+				<< std::right << std::setw(COL_TIME) << (time_ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << (keys.GetNumOfKeys() / (time_ns / NS_PER_SEC))
+				<< "\n";
+		};
+
+	// heap bytes of strings that did not fit the small string buffer
+	auto string_heap = [](const std::string& s) -> size_t
+		{
+			return s.capacity() > std::string{}.capacity() ? s.capacity() + 1 : 0;
+		};
+
+	size_t string_bytes = 0;
+	size_t inline_bytes = 0;
+	size_t entries = 0;
+
+	{
+		StringList mem;
+		const size_t base = g_counted_bytes;
+
+		const auto t0 = timestamp();
+		for (const auto& [key, value] : keys.GetKeys())
+			mem.insert({ key, value });
+		const auto t1 = timestamp();
+
+		size_t found = 0;
+		const auto t2 = timestamp();
+		for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
+			found += !mem.find(keys.PickRandomKey())->second.empty();
+		const auto t3 = timestamp();
+		assert(found == keys.GetNumOfKeys());
+
+		string_bytes = g_counted_bytes - base;
+		for (const auto& [key, value] : mem)
+			string_bytes += string_heap(key) + string_heap(value);
+		entries = mem.size();
+
+		print_row("std::string Insert", t1 - t0);
+		print_row("std::string Find", t3 - t2);
+	}
+
+	{
+		InlineList mem;
+		const size_t base = g_counted_bytes;
+
+		const auto t0 = timestamp();
+		for (const auto& [key, value] : keys.GetKeys())
+			mem.insert(key, value);
+		const auto t1 = timestamp();
+
+		size_t found = 0;
+		const auto t2 = timestamp();
+		for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
+			found += !mem.find(keys.PickRandomKey())->second.empty();
+		const auto t3 = timestamp();
+		assert(found == keys.GetNumOfKeys());
+
+		inline_bytes = g_counted_bytes - base;
+
+		print_row("Inline Insert", t1 - t0);
+		print_row("Inline Find", t3 - t2);
+	}
+
+	std::cout << std::left << std::setw(COL_NAME) << "std::string B/entry"
+		<< std::right << std::setw(COL_TIME) << (double)string_bytes / entries << "\n";
+	std::cout << std::left << std::setw(COL_NAME) << "Inline B/entry"
+		<< std::right << std::setw(COL_TIME) << (double)inline_bytes / entries << "\n";
+}
+
+void benchmark6()
+{
+	Benchmark::Keys keys{};
+
+	using HeapList = SkipList<std::string, std::string, std::less<std::string>, CountingAllocator<std::pair<const std::string, std::string>>>;
+	using ArenaList = SkipList<std::string, std::string, std::less<std::string>, ArenaAllocator<std::pair<const std::string, std::string>>>;
+	using HeapIntList = SkipList<uint64_t, uint64_t, std::less<uint64_t>, CountingAllocator<std::pair<const uint64_t, uint64_t>>>;
+	using ArenaIntList = SkipList<uint64_t, uint64_t, std::less<uint64_t>, ArenaAllocator<std::pair<const uint64_t, uint64_t>>>;
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 24;
+	constexpr int COL_TIME = 16;
+	constexpr int COL_OPS = 18;
+	constexpr int COL_MEM = 18;
+	constexpr int COL_CLEAR = 16;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Node Allocation Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Structure"
+		<< std::right << std::setw(COL_TIME) << "Insert (ms)"
+		<< std::right << std::setw(COL_OPS) << "Insert ops/sec"
+		<< std::right << std::setw(COL_MEM) << "Node bytes"
+		<< std::right << std::setw(COL_CLEAR) << "Clear (ms)\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS + COL_MEM + COL_CLEAR, '-') << "\n";
+
+	auto print_row = [&](const char* name, double insert_ns, size_t bytes, double clear_ns)
+		{
+			std::cout << std::left << std::setw(COL_NAME) << name
+				<< std::right << std::setw(COL_TIME) << (insert_ns / 1e6)
+				<< std::right << std::setw(COL_OPS) << (keys.GetNumOfKeys() / (insert_ns / NS_PER_SEC))
+				<< std::right << std::setw(COL_MEM) << bytes
+				<< std::right << std::setw(COL_CLEAR) << (clear_ns / 1e6)
+				<< "\n";
+		};
+
+	{
+		HeapList mem;
+		const size_t base = g_counted_bytes;
+
+		const auto t0 = timestamp();
+		for (const auto& [key, value] : keys.GetKeys())
+			mem.insert({ key, value });
+		const auto t1 = timestamp();
+
+		const size_t bytes = g_counted_bytes - base;
+
+		const auto t2 = timestamp();
+		mem.clear();
+		const auto t3 = timestamp();
+
+		print_row("std::allocator", t1 - t0, bytes, t3 - t2);
+	}
+
+	{
+		ArenaList mem;
+
+		const auto t0 = timestamp();
+		for (const auto& [key, value] : keys.GetKeys())
+			mem.insert({ key, value });
+		const auto t1 = timestamp();
+
+		const size_t bytes = mem.get_allocator().arena().bytes_reserved();
+
+		const auto t2 = timestamp();
+		mem.clear();
+		const auto t3 = timestamp();
+
+		print_row("Arena", t1 - t0, bytes, t3 - t2);
+	}
+
+	{
+		HeapIntList mem;
+		const size_t base = g_counted_bytes;
+
+		const auto t0 = timestamp();
+		for (uint64_t i = 0; i < keys.GetNumOfKeys(); ++i)
+			mem.insert({ (i * 0x9E3779B97F4A7C15ull), i });
+		const auto t1 = timestamp();
+
+		const size_t bytes = g_counted_bytes - base;
+
+		const auto t2 = timestamp();
+		mem.clear();
+		const auto t3 = timestamp();
+
+		print_row("std::allocator (u64)", t1 - t0, bytes, t3 - t2);
+	}
+
+	{
+		ArenaIntList mem;
+
+		const auto t0 = timestamp();
+		for (uint64_t i = 0; i < keys.GetNumOfKeys(); ++i)
+			mem.insert({ (i * 0x9E3779B97F4A7C15ull), i });
+		const auto t1 = timestamp();
+
+		const size_t bytes = mem.get_allocator().arena().bytes_reserved();
+
+		const auto t2 = timestamp();
+		mem.clear();
+		const auto t3 = timestamp();
+
+		print_row("Arena (u64)", t1 - t0, bytes, t3 - t2);
+	}
+}
+
+void benchmark5()
+{
+	Benchmark::Keys keys{};
+
+	const auto& kvs = keys.GetKeys();
+	const size_t total = kvs.size();
+
+	constexpr double NS_PER_SEC = 1e9;
+	constexpr int COL_NAME = 18;
+	constexpr int COL_TIME = 18;
+	constexpr int COL_OPS = 18;
+
+	std::cout.imbue(std::locale(""));
+	std::cout << std::fixed << std::setprecision(3);
+
+	std::cout << "\n=== Concurrent Scaling Benchmark ===\n";
+
+	std::cout << std::left << std::setw(COL_NAME) << "Threads"
+		<< std::right << std::setw(COL_TIME) << "Time (ms)"
+		<< std::right << std::setw(COL_OPS) << "Ops/sec\n";
+
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+
+	const unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned threads = 1; threads <= max_threads; threads *= 2)
+	{
+		ConcurrentSkipList<std::string, std::string> mem;
+
+		// every thread inserts its own slice and then looks up keys across the
+		// whole key set, so readers and writers overlap
+		auto worker = [&](unsigned id)
+			{
+				const size_t begin = total * id / threads;
+				const size_t end = total * (id + 1) / threads;
+
+				for (size_t i = begin; i < end; ++i)
+					mem.insert({ kvs[i].first, kvs[i].second });
+
+				for (size_t i = begin; i < end; ++i)
+					mem.find(kvs[(i * 7919) % total].first);
+			};
+
+		const auto t0 = timestamp();
+		std::vector<std::thread> pool;
+		pool.reserve(threads);
+		for (unsigned id = 0; id < threads; ++id)
+			pool.emplace_back(worker, id);
+		for (auto& t : pool)
+			t.join();
+		const auto t1 = timestamp();
+
+		assert(mem.size() <= total);
+
+		const auto ns = t1 - t0;
+		const double ops = (2.0 * total) / (ns / NS_PER_SEC);
+
+		std::cout << std::left << std::setw(COL_NAME) << threads
+			<< std::right << std::setw(COL_TIME) << (ns / 1e6)
+			<< std::right << std::setw(COL_OPS) << ops
+			<< "\n";
+	}
+}
+
 void benchmark4()
 {
 	Benchmark::Keys keys{};
@@ -46,41 +1802,54 @@ void benchmark4()
 	SkipList<std::string, std::string, decltype(optimized_less_1)>	mem1;
 	SkipList<std::string, std::string, decltype(optimized_less_2)>	mem2;
 
+	std::map<std::string, std::string>								ref;
+
 	for (const auto& [k, v] : keys.GetKeys())
 	{
+		ref.insert({ k, v });
 		mem.insert({ k, v });
 		mem1.insert({ k, v });
 		mem2.insert({ k, v });
 	}
 
+	size_t dev0 = 0;
 	size_t dev1 = 0;
 	size_t dev2 = 0;
 	size_t total = 0;
 
+	auto it0 = mem.begin();
 	auto it1 = mem1.begin();
 	auto it2 = mem2.begin();
 
-	for (const auto& [base_key, _] : mem)
+	for (const auto& [base_key, _] : ref)
 	{
+		if (it0 == mem.end())
+			break;
+
 		if (it1 == mem1.end())
 			break;
 
 		if (it2 == mem2.end())
 			break;
 
+		if (base_key != it0->first)
+			++dev0;
+
 		if (base_key != it1->first)
 			++dev1;
 
 		if (base_key != it2->first)
 			++dev2;
 
+		++it0;
 		++it1;
 		++it2;
 		++total;
 	}
 
-	const double dev1_pct = 100.0 * (dev1 / total);
-	const double dev2_pct = 100.0 * (dev2 / total);
+	const double dev0_pct = 100.0 * dev0 / total;
+	const double dev1_pct = 100.0 * dev1 / total;
+	const double dev2_pct = 100.0 * dev2 / total;
 
 	constexpr int COL_NAME = 30;
 	constexpr int COL_DEV = 18;
@@ -95,6 +1864,9 @@ void benchmark4()
 
 	std::cout << std::string(COL_NAME + COL_DEV, '-') << "\n";
 
+	std::cout << std::left << std::setw(COL_NAME) << "Cached 8 byte prefix"
+		<< std::right << std::setw(COL_DEV) << dev0_pct << "\n";
+
 	std::cout << std::left << std::setw(COL_NAME) << "Prefix 1 character"
 		<< std::right << std::setw(COL_DEV) << dev1_pct << "\n";
 
@@ -119,34 +1891,62 @@ void benchmark3()
 			return a.size() < b.size();
 		};
 
-	SkipList<std::string, std::string>								mem;
-	SkipList<std::string, std::string, decltype(optimized_less)>	mem1;
+	// same ordering as std::less but opaque to the key prefix cache
+	auto plain_less = [](const std::string& a, const std::string& b)
+		{
+			return a < b;
+		};
+
+	using Pair = std::pair<const std::string, std::string>;
+	using Counted = SkipListCounters<>;
 
+	SkipList<std::string, std::string, std::less<std::string>, std::allocator<Pair>, 12, 1, 4, XorShiftHeight, Counted>	mem;
+	SkipList<std::string, std::string, decltype(optimized_less), std::allocator<Pair>, 12, 1, 4, XorShiftHeight, Counted>	mem1;
+	SkipList<std::string, std::string, decltype(plain_less), std::allocator<Pair>, 12, 1, 4, XorShiftHeight, Counted>		mem2;
+
+	size_t found = 0;
 	auto t0 = timestamp();
-	for (const auto [key, value] : keys.GetKeys())
+	for (const auto& [key, value] : keys.GetKeys())
 		mem.insert({ key, value });
 	auto t1 = timestamp();
+	const Counted mem_insert = mem.counters();
+	mem.counters().reset();
 
 	auto t3 = timestamp();
-	for (int i = 0; i < keys.GetNumOfKeys(); ++i)
-	{
-		const auto it = mem.find(keys.PickRandomKey());
-		assert(!it->second.empty());
-	}
+	for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
+		found += !mem.find(keys.PickRandomKey())->second.empty();
 	auto t4 = timestamp();
+	const Counted mem_find = mem.counters();
 
 	auto t5 = timestamp();
-	for (const auto [key, value] : keys.GetKeys())
+	for (const auto& [key, value] : keys.GetKeys())
 		mem1.insert({ key, value });
 	auto t6 = timestamp();
+	const Counted mem1_insert = mem1.counters();
+	mem1.counters().reset();
 
 	auto t7 = timestamp();
-	for (int i = 0; i < keys.GetNumOfKeys(); ++i)
+	for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
 	{
-		const auto it = mem.find(keys.PickRandomKey());
-		assert(!it->second.empty());
+		const auto it = mem1.find(keys.PickRandomKey());
+		found += it == mem1.end() || !it->second.empty();
 	}
 	auto t8 = timestamp();
+	const Counted mem1_find = mem1.counters();
+
+	auto t9 = timestamp();
+	for (const auto& [key, value] : keys.GetKeys())
+		mem2.insert({ key, value });
+	auto t10 = timestamp();
+	const Counted mem2_insert = mem2.counters();
+	mem2.counters().reset();
+
+	auto t11 = timestamp();
+	for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
+		found += !mem2.find(keys.PickRandomKey())->second.empty();
+	auto t12 = timestamp();
+	const Counted mem2_find = mem2.counters();
+	assert(found == 3 * (size_t)keys.GetNumOfKeys());
 
 	constexpr int COL_NAME = 28;
 	constexpr int COL_TIME = 18;
@@ -158,6 +1958,8 @@ void benchmark3()
 	const auto def_find_ns = t4 - t3;
 	const auto opt_insert_ns = t6 - t5;
 	const auto opt_find_ns = t8 - t7;
+	const auto plain_insert_ns = t10 - t9;
+	const auto plain_find_ns = t12 - t11;
 
 	const double def_insert_ops =
 		keys.GetNumOfKeys() / (def_insert_ns / NS_PER_SEC);
@@ -167,30 +1969,42 @@ void benchmark3()
 		keys.GetNumOfKeys() / (opt_insert_ns / NS_PER_SEC);
 	const double opt_find_ops =
 		keys.GetNumOfKeys() / (opt_find_ns / NS_PER_SEC);
+	const double plain_insert_ops =
+		keys.GetNumOfKeys() / (plain_insert_ns / NS_PER_SEC);
+	const double plain_find_ops =
+		keys.GetNumOfKeys() / (plain_find_ns / NS_PER_SEC);
 
 	std::cout.imbue(std::locale(""));
 	std::cout << std::fixed << std::setprecision(3);
 
 	std::cout << "\n=== SkipList Comparator Benchmark ===\n";
 
+	constexpr int COL_COUNT = 14;
+
 	std::cout << std::left << std::setw(COL_NAME) << "Operation"
 		<< std::right << std::setw(COL_TIME) << "Time (ms)"
-		<< std::right << std::setw(COL_OPS) << "Ops/sec\n";
+		<< std::right << std::setw(COL_OPS) << "Ops/sec"
+		<< std::right << std::setw(COL_COUNT) << "Cmp/Search"
+		<< std::right << std::setw(COL_COUNT) << "Hops/Search\n";
 
-	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS, '-') << "\n";
+	std::cout << std::string(COL_NAME + COL_TIME + COL_OPS + 2 * COL_COUNT, '-') << "\n";
 
-	auto print_row = [&](const char* name, double time_ns, double ops)
+	auto print_row = [&](const char* name, double time_ns, double ops, const Counted& counters)
 		{
 			std::cout << std::left << std::setw(COL_NAME) << name
 				<< std::right << std::setw(COL_TIME) << (time_ns / 1e6)
 				<< std::right << std::setw(COL_OPS) << ops
+				<< std::right << std::setw(COL_COUNT) << counters.comparisons_per_search()
+				<< std::right << std::setw(COL_COUNT) << counters.visits_per_search()
 				<< "\n";
 		};
 
-	print_row("Default Insert", def_insert_ns, def_insert_ops);
-	print_row("Default Find", def_find_ns, def_find_ops);
-	print_row("Optimized Insert", opt_insert_ns, opt_insert_ops);
-	print_row("Optimized Find", opt_find_ns, opt_find_ops);
+	print_row("Plain Insert", plain_insert_ns, plain_insert_ops, mem2_insert);
+	print_row("Plain Find", plain_find_ns, plain_find_ops, mem2_find);
+	print_row("Prefix Cached Insert", def_insert_ns, def_insert_ops, mem_insert);
+	print_row("Prefix Cached Find", def_find_ns, def_find_ops, mem_find);
+	print_row("Truncated Insert", opt_insert_ns, opt_insert_ops, mem1_insert);
+	print_row("Truncated Find", opt_find_ns, opt_find_ops, mem1_find);
 }
 
 void benchmark2()
@@ -200,13 +2014,14 @@ void benchmark2()
 	SkipList<std::string, std::string>				mem;
 	std::map<std::string, std::string>				mem2;
 	std::unordered_map<std::string, std::string>	mem3;
-	
+	UnrolledSkipList<std::string, std::string>		mem4;
+
 	std::random_device rd{};
 	std::mt19937 gen(rd());
 	std::uniform_int_distribution<int> dist(0, 2);
 
 	const auto t1 = timestamp();
-	for (int i{}; i < keys.GetNumOfKeys(); ++i)
+	for (size_t i{}; i < keys.GetNumOfKeys(); ++i)
 	{
 		int choice = dist(gen);
 
@@ -228,7 +2043,7 @@ void benchmark2()
 	const auto t2 = timestamp();
 
 	const auto t3 = timestamp();
-	for (int i{}; i < keys.GetNumOfKeys(); ++i)
+	for (size_t i{}; i < keys.GetNumOfKeys(); ++i)
 	{
 		int choice = dist(gen);
 
@@ -250,20 +2065,20 @@ void benchmark2()
 	const auto t4 = timestamp();
 
 	const auto t5 = timestamp();
-	for (int i{}; i < keys.GetNumOfKeys(); ++i)
+	for (size_t i{}; i < keys.GetNumOfKeys(); ++i)
 	{
 		int choice = dist(gen);
 
 		switch (choice)
 		{
 		case 0:
-			mem2.insert(keys.PickRandomKV());
+			mem3.insert(keys.PickRandomKV());
 			break;
 		case 1:
-			mem2.find(keys.PickRandomKey());
+			mem3.find(keys.PickRandomKey());
 			break;
 		case 2:
-			mem2.erase(keys.PickRandomKey());
+			mem3.erase(keys.PickRandomKey());
 			break;
 		default:
 			break;
@@ -271,6 +2086,28 @@ void benchmark2()
 	}
 	const auto t6 = timestamp();
 
+	const auto t7 = timestamp();
+	for (size_t i{}; i < keys.GetNumOfKeys(); ++i)
+	{
+		int choice = dist(gen);
+
+		switch (choice)
+		{
+		case 0:
+			mem4.insert(keys.PickRandomKV());
+			break;
+		case 1:
+			mem4.find(keys.PickRandomKey());
+			break;
+		case 2:
+			mem4.erase(keys.PickRandomKey());
+			break;
+		default:
+			break;
+		}
+	}
+	const auto t8 = timestamp();
+
 	constexpr int COL_NAME = 18;
 	constexpr int COL_TIME = 18;
 	constexpr int COL_OPS = 18;
@@ -280,10 +2117,12 @@ void benchmark2()
 	const auto skip_ns = t2 - t1;
 	const auto map_ns = t4 - t3;
 	const auto hash_ns = t6 - t5;
+	const auto unrolled_ns = t8 - t7;
 
 	const double skip_ops = keys.GetNumOfKeys() / (skip_ns / NS_PER_SEC);
 	const double map_ops = keys.GetNumOfKeys() / (map_ns / NS_PER_SEC);
 	const double hash_ops = keys.GetNumOfKeys() / (hash_ns / NS_PER_SEC);
+	const double unrolled_ops = keys.GetNumOfKeys() / (unrolled_ns / NS_PER_SEC);
 
 	std::cout.imbue(std::locale(""));
 	std::cout << std::fixed << std::setprecision(3);
@@ -307,6 +2146,7 @@ void benchmark2()
 	print_row("SkipList", skip_ns, skip_ops);
 	print_row("Map", map_ns, map_ops);
 	print_row("HashMap", hash_ns, hash_ops);
+	print_row("UnrolledSkipList", unrolled_ns, unrolled_ops);
 }
 
 void benchmark1()
@@ -316,23 +2156,23 @@ void benchmark1()
 	SkipList<std::string, std::string>				mem;
 	std::map<std::string, std::string>				mem2;
 	std::unordered_map<std::string, std::string>	mem3;
+	UnrolledSkipList<std::string, std::string>		mem4;
+
+	size_t found = 0;
 
 	// Skiplist section
 	auto t0 = timestamp();
-	for (const auto [key, value] : keys.GetKeys())
+	for (const auto& [key, value] : keys.GetKeys())
 		mem.insert({ key, value });
 	auto t1 = timestamp();
 
 	auto t2 = timestamp();
-	for (int i = 0; i < keys.GetNumOfKeys(); ++i)
-	{
-		const auto it = mem.find(keys.PickRandomKey());
-		assert(!it->second.empty());
-	}
+	for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
+		found += !mem.find(keys.PickRandomKey())->second.empty();
 	auto t3 = timestamp();
 
 	auto t4 = timestamp();
-	for (int i = 0; i < keys.GetNumOfKeys(); ++i)
+	for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
 		mem.erase(keys.PickRandomKey());
 	auto t5 = timestamp();
 
@@ -340,20 +2180,17 @@ void benchmark1()
 
 	// map section
 	auto t6 = timestamp();
-	for (const auto [key, value] : keys.GetKeys())
+	for (const auto& [key, value] : keys.GetKeys())
 		mem2.insert({ key, value });
 	auto t7 = timestamp();
 
 	auto t8 = timestamp();
-	for (int i = 0; i < keys.GetNumOfKeys(); ++i)
-	{
-		const auto it = mem2.find(keys.PickRandomKey());
-		assert(!it->second.empty());
-	}
+	for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
+		found += !mem2.find(keys.PickRandomKey())->second.empty();
 	auto t9 = timestamp();
 
 	auto t10 = timestamp();
-	for (int i = 0; i < keys.GetNumOfKeys(); ++i)
+	for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
 		mem2.erase(keys.PickRandomKey());
 	auto t11 = timestamp();
 
@@ -361,25 +2198,41 @@ void benchmark1()
 
 	// Hashmap
 	auto t12 = timestamp();
-	for (const auto [key, value] : keys.GetKeys())
+	for (const auto& [key, value] : keys.GetKeys())
 		mem3.insert({ key, value });
 	auto t13 = timestamp();
 
 	auto t14 = timestamp();
-	for (int i = 0; i < keys.GetNumOfKeys(); ++i)
-	{
-		const auto it = mem3.find(keys.PickRandomKey());
-		assert(!it->second.empty());
-	}
+	for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
+		found += !mem3.find(keys.PickRandomKey())->second.empty();
 	auto t15 = timestamp();
 
 	auto t16 = timestamp();
-	for (int i = 0; i < keys.GetNumOfKeys(); ++i)
+	for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
 		mem3.erase(keys.PickRandomKey());
 	auto t17 = timestamp();
 
 	mem3.clear();
 
+	// unrolled skiplist section
+	auto t18 = timestamp();
+	for (const auto& [key, value] : keys.GetKeys())
+		mem4.insert({ key, value });
+	auto t19 = timestamp();
+
+	auto t20 = timestamp();
+	for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
+		found += !mem4.find(keys.PickRandomKey())->second.empty();
+	auto t21 = timestamp();
+	assert(found == 4 * (size_t)keys.GetNumOfKeys());
+
+	auto t22 = timestamp();
+	for (size_t i = 0; i < keys.GetNumOfKeys(); ++i)
+		mem4.erase(keys.PickRandomKey());
+	auto t23 = timestamp();
+
+	mem4.clear();
+
 
 	constexpr double NS_PER_SEC = 1e9;
 
@@ -410,7 +2263,16 @@ void benchmark1()
 	double hash_find_ops = keys.GetNumOfKeys() / (hash_find_ns / NS_PER_SEC);
 	double hash_erase_ops = keys.GetNumOfKeys() / (hash_erase_ns / NS_PER_SEC);
 
-	constexpr int COL_NAME = 18;
+	//unrolled numbers
+	auto unrolled_insert_ns = t19 - t18;
+	auto unrolled_find_ns = t21 - t20;
+	auto unrolled_erase_ns = t23 - t22;
+
+	double unrolled_insert_ops = keys.GetNumOfKeys() / (unrolled_insert_ns / NS_PER_SEC);
+	double unrolled_find_ops = keys.GetNumOfKeys() / (unrolled_find_ns / NS_PER_SEC);
+	double unrolled_erase_ops = keys.GetNumOfKeys() / (unrolled_erase_ns / NS_PER_SEC);
+
+	constexpr int COL_NAME = 20;
 	constexpr int COL_TIME = 18;
 	constexpr int COL_OPS = 18;
 
@@ -444,14 +2306,42 @@ void benchmark1()
 	print_row("Hash Insert", hash_insert_ns, hash_insert_ops);
 	print_row("Hash Get", hash_find_ns, hash_find_ops);
 	print_row("Hash Erase", hash_erase_ns, hash_erase_ops);
+
+	print_row("Unrolled Insert", unrolled_insert_ns, unrolled_insert_ops);
+	print_row("Unrolled Get", unrolled_find_ns, unrolled_find_ops);
+	print_row("Unrolled Erase", unrolled_erase_ns, unrolled_erase_ops);
 }
 
-int main() 
+int main(int argc, char** argv) 
 {
+	// Any flag switches to the configurable harness, see --help.
+	if (argc > 1)
+		return Benchmark::HarnessMain(argc, argv);
+
 	benchmark1();
 	benchmark2();
 	benchmark3();
 	//benchmark4();
+	benchmark5();
+	benchmark6();
+	benchmark7();
+	benchmark8();
+	benchmark9();
+	benchmark10();
+	benchmark11();
+	benchmark12();
+	benchmark13();
+	benchmark14();
+	benchmark15();
+	benchmark17();
+	benchmark18();
+	benchmark19();
+	benchmark20();
+	benchmark21();
+	benchmark22();
+	benchmark23();
+	benchmark24();
+	benchmark25();
 
 	return 1;
 }
\ No newline at end of file
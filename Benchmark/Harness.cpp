@@ -0,0 +1,614 @@
+#include <Harness.h>
+
+#include <SimpleSTL/Types/SkipList.h>
+#include <SimpleSTL/Types/UnrolledSkipList.h>
+#include <SimpleSTL/Types/ByteSkipList.h>
+#include <SimpleSTL/Memory/Arena.h>
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+	enum class OpType : uint8_t
+	{
+		Read,
+		Update,
+		Insert,
+		Scan,
+		ReadModifyWrite
+	};
+
+	struct Op
+	{
+		OpType		type;
+		uint32_t	key;
+		uint32_t	scan_length;
+	};
+
+	// Operation mix of the YCSB core workloads. D reads the most recently
+	// inserted keys, the others draw keys from a scrambled zipfian.
+	struct Workload
+	{
+		char	name;
+		double	read;
+		double	update;
+		double	insert;
+		double	scan;
+		double	read_modify_write;
+		bool	latest;
+	};
+
+	constexpr Workload Workloads[] = {
+		{ 'A', 0.50, 0.50, 0.00, 0.00, 0.00, false },
+		{ 'B', 0.95, 0.05, 0.00, 0.00, 0.00, false },
+		{ 'C', 1.00, 0.00, 0.00, 0.00, 0.00, false },
+		{ 'D', 0.95, 0.00, 0.05, 0.00, 0.00, true },
+		{ 'E', 0.00, 0.00, 0.05, 0.95, 0.00, false },
+		{ 'F', 0.50, 0.00, 0.00, 0.00, 0.50, false },
+	};
+
+	constexpr uint32_t MaxScanLength = 100;
+	constexpr size_t ValuePoolSize = 64;
+
+	const char* const Structures[] = { "skiplist", "arena", "unrolled", "bytes", "map", "hashmap" };
+
+	const Workload* find_workload(char name)
+	{
+		for (const Workload& w : Workloads)
+		{
+			if (w.name == name)
+				return &w;
+		}
+		return nullptr;
+	}
+
+	uint64_t timestamp()
+	{
+		using clock = std::chrono::steady_clock;
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+	}
+
+	uint64_t fnv1a(uint64_t x)
+	{
+		uint64_t h = 0xcbf29ce484222325ull;
+		for (int i = 0; i < 8; ++i)
+		{
+			h ^= (x >> (8 * i)) & 0xff;
+			h *= 0x100000001b3ull;
+		}
+		return h;
+	}
+
+	// Bijective 32 bit mix, record i always gets the same distinct key while
+	// insertion order stays unrelated to key order.
+	uint32_t permute(uint32_t x)
+	{
+		x ^= x >> 16;
+		x *= 0x7feb352dU;
+		x ^= x >> 15;
+		x *= 0x846ca68bU;
+		x ^= x >> 16;
+		return x;
+	}
+
+	std::string make_key(uint32_t index, uint32_t key_size)
+	{
+		static constexpr char hex[] = "0123456789abcdef";
+
+		std::string key(key_size, '0');
+		const uint32_t v = permute(index);
+		for (int i = 0; i < 8; ++i)
+			key[i] = hex[(v >> (28 - 4 * i)) & 0xf];
+		return key;
+	}
+
+	// YCSB's zipfian generator (Gray et al., "Quickly generating billion-record
+	// synthetic databases"), rank 0 is the most popular item.
+	class Zipfian
+	{
+	public:
+		Zipfian(uint64_t n, double theta)
+			:	m_n(n)
+		{
+			m_zetan = zeta(n, theta);
+			m_alpha = 1.0 / (1.0 - theta);
+			m_eta = (1.0 - std::pow(2.0 / (double)n, 1.0 - theta)) / (1.0 - zeta(2, theta) / m_zetan);
+			m_half_pow_theta = 1.0 + std::pow(0.5, theta);
+		}
+
+		uint64_t next(double u) const
+		{
+			const double uz = u * m_zetan;
+			if (uz < 1.0)
+				return 0;
+			if (uz < m_half_pow_theta)
+				return 1;
+
+			return std::min<uint64_t>(m_n - 1, (uint64_t)((double)m_n * std::pow(m_eta * u - m_eta + 1.0, m_alpha)));
+		}
+
+	private:
+		static double zeta(uint64_t n, double theta)
+		{
+			double sum = 0.0;
+			for (uint64_t i = 1; i <= n; ++i)
+				sum += 1.0 / std::pow((double)i, theta);
+			return sum;
+		}
+
+		uint64_t	m_n;
+		double		m_zetan = 0.0;
+		double		m_alpha = 0.0;
+		double		m_eta = 0.0;
+		double		m_half_pow_theta = 0.0;
+	};
+
+	// Warmup followed by the measured operations, generated up front so the
+	// random draws are not timed and every structure replays the same tape.
+	std::vector<Op> make_tape(const Workload& w, const Benchmark::HarnessOptions& o, uint32_t& record_count)
+	{
+		std::mt19937_64 rng(o.seed ^ ((uint64_t)w.name << 32));
+		std::uniform_real_distribution<double> uni(0.0, 1.0);
+		std::uniform_int_distribution<uint32_t> scan_length(1, MaxScanLength);
+
+		const Zipfian zipf(o.records, o.theta);
+		uint32_t count = o.records;
+
+		std::vector<Op> tape;
+		tape.reserve((size_t)o.warmup + o.operations);
+		for (size_t i = 0; i < (size_t)o.warmup + o.operations; ++i)
+		{
+			double u = uni(rng);
+
+			OpType type = OpType::ReadModifyWrite;
+			if ((u -= w.read) < 0.0)
+				type = OpType::Read;
+			else if ((u -= w.update) < 0.0)
+				type = OpType::Update;
+			else if ((u -= w.insert) < 0.0)
+				type = OpType::Insert;
+			else if ((u -= w.scan) < 0.0)
+				type = OpType::Scan;
+
+			if (type == OpType::Insert)
+			{
+				tape.push_back({ type, count++, 0 });
+				continue;
+			}
+
+			const uint64_t rank = zipf.next(uni(rng));
+			const uint32_t key = w.latest
+				? count - 1 - (uint32_t)std::min<uint64_t>(rank, count - 1)
+				: (uint32_t)(fnv1a(rank) % count);
+
+			tape.push_back({ type, key, type == OpType::Scan ? scan_length(rng) : 0 });
+		}
+
+		record_count = std::max(record_count, count);
+		return tape;
+	}
+
+	struct Dataset
+	{
+		std::vector<std::string> keys;
+		std::vector<std::string> values;
+
+		const std::string& value(size_t i) const { return values[i % values.size()]; }
+	};
+
+	// One front-end over every structure: point reads, blind writes and
+	// ordered scans of up to `length` entries.
+	template<class Map>
+	struct Store
+	{
+		Map map{};
+
+		bool read(const std::string& key)
+		{
+			return map.find(key) != map.end();
+		}
+
+		void write(const std::string& key, const std::string& value)
+		{
+			map.insert_or_assign(key, value);
+		}
+
+		static constexpr bool ordered = requires(Map& m, const std::string& k) { m.lower_bound(k); };
+
+		uint64_t scan(const std::string& key, uint32_t length)
+		{
+			uint64_t found = 0;
+			if constexpr (ordered)
+			{
+				for (auto it = map.lower_bound(key); it != map.end() && found < length; ++it)
+					++found;
+			}
+			return found;
+		}
+	};
+
+	template<class S>
+	uint64_t execute(S& store, const Dataset& data, const std::vector<Op>& tape, size_t first, size_t last)
+	{
+		uint64_t hits = 0;
+		for (size_t i = first; i < last; ++i)
+		{
+			const Op& op = tape[i];
+			const std::string& key = data.keys[op.key];
+
+			switch (op.type)
+			{
+			case OpType::Read:
+				hits += store.read(key);
+				break;
+			case OpType::Update:
+			case OpType::Insert:
+				store.write(key, data.value(i));
+				break;
+			case OpType::Scan:
+				hits += store.scan(key, op.scan_length);
+				break;
+			case OpType::ReadModifyWrite:
+				hits += store.read(key);
+				store.write(key, data.value(i));
+				break;
+			}
+		}
+		return hits;
+	}
+
+	template<class S>
+	Benchmark::HarnessResult run_once(const std::string& name, char workload, uint32_t repetition,
+		const Benchmark::HarnessOptions& o, const Dataset& data, const std::vector<Op>& tape)
+	{
+		Benchmark::HarnessResult r{ name, workload, repetition };
+
+		S store{};
+
+		const auto t0 = timestamp();
+		for (uint32_t i = 0; i < o.records; ++i)
+			store.write(data.keys[i], data.value(i));
+		const auto t1 = timestamp();
+
+		execute(store, data, tape, 0, o.warmup);
+
+		const auto t2 = timestamp();
+		r.hits = execute(store, data, tape, o.warmup, tape.size());
+		const auto t3 = timestamp();
+
+		r.load_ns = t1 - t0;
+		r.run_ns = t3 - t2;
+		return r;
+	}
+
+	template<class S>
+	void run_structure(const std::string& name, const Workload& w, const Benchmark::HarnessOptions& o,
+		const Dataset& data, const std::vector<Op>& tape, std::vector<Benchmark::HarnessResult>& results)
+	{
+		if (w.scan > 0.0 && !S::ordered)
+		{
+			std::cerr << name << " has no ordered scan, skipping workload " << w.name << "\n";
+			return;
+		}
+
+		for (uint32_t rep = 0; rep < o.repeat; ++rep)
+			results.push_back(run_once<S>(name, w.name, rep, o, data, tape));
+	}
+
+	using SkipListStore = Store<SkipList<std::string, std::string>>;
+	using ArenaStore = Store<SkipList<std::string, std::string, std::less<std::string>, ArenaAllocator<std::pair<const std::string, std::string>>>>;
+	using UnrolledStore = Store<UnrolledSkipList<std::string, std::string>>;
+	using ByteStore = Store<ByteSkipList<>>;
+	using MapStore = Store<std::map<std::string, std::string>>;
+	using HashMapStore = Store<std::unordered_map<std::string, std::string>>;
+
+	void dispatch(const std::string& name, const Workload& w, const Benchmark::HarnessOptions& o,
+		const Dataset& data, const std::vector<Op>& tape, std::vector<Benchmark::HarnessResult>& results)
+	{
+		if (name == "skiplist")
+			run_structure<SkipListStore>(name, w, o, data, tape, results);
+		else if (name == "arena")
+			run_structure<ArenaStore>(name, w, o, data, tape, results);
+		else if (name == "unrolled")
+			run_structure<UnrolledStore>(name, w, o, data, tape, results);
+		else if (name == "bytes")
+			run_structure<ByteStore>(name, w, o, data, tape, results);
+		else if (name == "map")
+			run_structure<MapStore>(name, w, o, data, tape, results);
+		else if (name == "hashmap")
+			run_structure<HashMapStore>(name, w, o, data, tape, results);
+	}
+
+	std::vector<std::string> split(std::string_view s)
+	{
+		std::vector<std::string> parts;
+		while (!s.empty())
+		{
+			const size_t comma = s.find(',');
+			parts.emplace_back(s.substr(0, comma));
+			s = comma == std::string_view::npos ? std::string_view{} : s.substr(comma + 1);
+		}
+		return parts;
+	}
+
+	template<class T>
+	bool parse_number(std::string_view s, T& out)
+	{
+		const auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+		return ec == std::errc{} && end == s.data() + s.size();
+	}
+
+	double ops_per_sec(const Benchmark::HarnessOptions& o, const Benchmark::HarnessResult& r)
+	{
+		return r.run_ns ? o.operations / (r.run_ns / 1e9) : 0.0;
+	}
+}
+
+void Benchmark::PrintHarnessUsage(std::ostream& out, const char* program)
+{
+	out
+		<< "usage: " << program << " [--flag=value ...]\n"
+		<< "Without flags the fixed benchmark suite runs.\n\n"
+		<< "  --structure=LIST   skiplist, arena, unrolled, bytes, map, hashmap or all (skiplist)\n"
+		<< "  --workload=LIST    YCSB core workloads A-F or all (A)\n"
+		<< "                       A 50% read 50% update      B 95% read 5% update\n"
+		<< "                       C 100% read                D 95% read latest 5% insert\n"
+		<< "                       E 95% scan 5% insert       F 50% read 50% read-modify-write\n"
+		<< "  --records=N        keys loaded before the run (100000)\n"
+		<< "  --operations=N     measured operations per run (100000)\n"
+		<< "  --warmup=N         untimed operations before the measured ones (10000)\n"
+		<< "  --repeat=N         runs per structure and workload (3)\n"
+		<< "  --key-size=N       key bytes, at least 8 (16)\n"
+		<< "  --value-size=N     value bytes (100)\n"
+		<< "  --theta=X          zipfian skew in [0, 1) (0.99)\n"
+		<< "  --seed=N           seed of the operation tape (42)\n"
+		<< "  --format=F         table, csv or json (table)\n"
+		<< "  --output=PATH      write the results to PATH instead of stdout\n";
+}
+
+bool Benchmark::ParseHarnessOptions(int argc, char** argv, HarnessOptions& o, std::string& error)
+{
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string_view arg = argv[i];
+		if (arg == "-h" || arg == "--help")
+		{
+			o.help = true;
+			continue;
+		}
+
+		if (arg.substr(0, 2) != "--")
+		{
+			error = "unexpected argument '" + std::string(arg) + "'";
+			return false;
+		}
+		arg.remove_prefix(2);
+
+		std::string_view name = arg;
+		std::string_view value;
+		if (const size_t eq = arg.find('='); eq != std::string_view::npos)
+		{
+			name = arg.substr(0, eq);
+			value = arg.substr(eq + 1);
+		}
+		else if (i + 1 < argc)
+		{
+			value = argv[++i];
+		}
+		else
+		{
+			error = "missing value for --" + std::string(name);
+			return false;
+		}
+
+		bool ok = true;
+		if (name == "structure" || name == "structures")
+		{
+			o.structures = value == "all" ? std::vector<std::string>(std::begin(Structures), std::end(Structures)) : split(value);
+			for (const std::string& s : o.structures)
+				ok = ok && std::find(std::begin(Structures), std::end(Structures), s) != std::end(Structures);
+		}
+		else if (name == "workload" || name == "workloads")
+		{
+			o.workloads.clear();
+			for (const std::string& s : split(value == "all" ? "A,B,C,D,E,F" : value))
+			{
+				ok = ok && s.size() == 1 && find_workload((char)std::toupper((unsigned char)s[0]));
+				if (ok)
+					o.workloads.push_back((char)std::toupper((unsigned char)s[0]));
+			}
+		}
+		else if (name == "records")
+			ok = parse_number(value, o.records) && o.records > 0;
+		else if (name == "operations")
+			ok = parse_number(value, o.operations);
+		else if (name == "warmup")
+			ok = parse_number(value, o.warmup);
+		else if (name == "repeat")
+			ok = parse_number(value, o.repeat) && o.repeat > 0;
+		else if (name == "key-size")
+			ok = parse_number(value, o.key_size) && o.key_size >= 8;
+		else if (name == "value-size")
+			ok = parse_number(value, o.value_size);
+		else if (name == "theta")
+			ok = parse_number(value, o.theta) && o.theta >= 0.0 && o.theta < 1.0;
+		else if (name == "seed")
+			ok = parse_number(value, o.seed);
+		else if (name == "format")
+		{
+			o.format = value;
+			ok = o.format == "table" || o.format == "csv" || o.format == "json";
+		}
+		else if (name == "output")
+			o.output = value;
+		else
+		{
+			error = "unknown flag --" + std::string(name);
+			return false;
+		}
+
+		if (!ok)
+		{
+			error = "invalid value '" + std::string(value) + "' for --" + std::string(name);
+			return false;
+		}
+	}
+
+	if (o.structures.empty() || o.workloads.empty())
+	{
+		error = "nothing to run";
+		return false;
+	}
+
+	return true;
+}
+
+std::vector<Benchmark::HarnessResult> Benchmark::RunHarness(const HarnessOptions& o)
+{
+	std::vector<std::vector<Op>> tapes;
+	uint32_t record_count = o.records;
+	for (char name : o.workloads)
+		tapes.push_back(make_tape(*find_workload(name), o, record_count));
+
+	Dataset data;
+	data.keys.reserve(record_count);
+	for (uint32_t i = 0; i < record_count; ++i)
+		data.keys.push_back(make_key(i, o.key_size));
+
+	std::mt19937_64 rng(o.seed);
+	std::uniform_int_distribution<int> letter('a', 'z');
+	data.values.resize(ValuePoolSize);
+	for (std::string& v : data.values)
+	{
+		v.resize(o.value_size);
+		for (char& c : v)
+			c = (char)letter(rng);
+	}
+
+	std::vector<HarnessResult> results;
+	for (size_t w = 0; w < o.workloads.size(); ++w)
+	{
+		for (const std::string& s : o.structures)
+			dispatch(s, *find_workload(o.workloads[w]), o, data, tapes[w], results);
+	}
+
+	return results;
+}
+
+bool Benchmark::WriteHarnessResults(const HarnessOptions& o, const std::vector<HarnessResult>& results)
+{
+	std::ofstream file;
+	if (!o.output.empty())
+	{
+		file.open(o.output);
+		if (!file)
+			return false;
+	}
+
+	std::ostream& out = o.output.empty() ? std::cout : file;
+	out << std::fixed << std::setprecision(3);
+
+	if (o.format == "csv")
+	{
+		out << "structure,workload,records,operations,warmup,key_size,value_size,theta,repetition,load_ms,run_ms,ops_per_sec,hits\n";
+		for (const HarnessResult& r : results)
+		{
+			out << r.structure << ',' << r.workload << ',' << o.records << ',' << o.operations << ',' << o.warmup << ','
+				<< o.key_size << ',' << o.value_size << ',' << o.theta << ',' << r.repetition << ','
+				<< r.load_ns / 1e6 << ',' << r.run_ns / 1e6 << ',' << ops_per_sec(o, r) << ',' << r.hits << "\n";
+		}
+	}
+	else if (o.format == "json")
+	{
+		out << "{\n"
+			<< "  \"records\": " << o.records << ",\n"
+			<< "  \"operations\": " << o.operations << ",\n"
+			<< "  \"warmup\": " << o.warmup << ",\n"
+			<< "  \"key_size\": " << o.key_size << ",\n"
+			<< "  \"value_size\": " << o.value_size << ",\n"
+			<< "  \"theta\": " << o.theta << ",\n"
+			<< "  \"seed\": " << o.seed << ",\n"
+			<< "  \"results\": [";
+
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const HarnessResult& r = results[i];
+			out << (i ? ",\n" : "\n")
+				<< "    { \"structure\": \"" << r.structure << "\", \"workload\": \"" << r.workload << "\""
+				<< ", \"repetition\": " << r.repetition
+				<< ", \"load_ms\": " << r.load_ns / 1e6
+				<< ", \"run_ms\": " << r.run_ns / 1e6
+				<< ", \"ops_per_sec\": " << ops_per_sec(o, r)
+				<< ", \"hits\": " << r.hits << " }";
+		}
+
+		out << "\n  ]\n}\n";
+	}
+	else
+	{
+		constexpr int COL_NAME = 12;
+		constexpr int COL_SHORT = 10;
+		constexpr int COL_TIME = 14;
+		constexpr int COL_OPS = 18;
+
+		out << std::left << std::setw(COL_NAME) << "Structure"
+			<< std::left << std::setw(COL_SHORT) << "Workload"
+			<< std::left << std::setw(COL_SHORT) << "Rep"
+			<< std::right << std::setw(COL_TIME) << "Load (ms)"
+			<< std::right << std::setw(COL_TIME) << "Run (ms)"
+			<< std::right << std::setw(COL_OPS) << "Ops/sec"
+			<< std::right << std::setw(COL_TIME) << "Hits" << "\n";
+
+		out << std::string(COL_NAME + 2 * COL_SHORT + 3 * COL_TIME + COL_OPS, '-') << "\n";
+
+		for (const HarnessResult& r : results)
+		{
+			out << std::left << std::setw(COL_NAME) << r.structure
+				<< std::left << std::setw(COL_SHORT) << r.workload
+				<< std::left << std::setw(COL_SHORT) << r.repetition
+				<< std::right << std::setw(COL_TIME) << r.load_ns / 1e6
+				<< std::right << std::setw(COL_TIME) << r.run_ns / 1e6
+				<< std::right << std::setw(COL_OPS) << ops_per_sec(o, r)
+				<< std::right << std::setw(COL_TIME) << r.hits << "\n";
+		}
+	}
+
+	return bool(out);
+}
+
+int Benchmark::HarnessMain(int argc, char** argv)
+{
+	HarnessOptions options;
+	std::string error;
+	if (!ParseHarnessOptions(argc, argv, options, error))
+	{
+		std::cerr << error << "\n\n";
+		PrintHarnessUsage(std::cerr, argv[0]);
+		return 2;
+	}
+
+	if (options.help)
+	{
+		PrintHarnessUsage(std::cout, argv[0]);
+		return 0;
+	}
+
+	if (!WriteHarnessResults(options, RunHarness(options)))
+	{
+		std::cerr << "cannot write " << options.output << "\n";
+		return 1;
+	}
+
+	return 0;
+}
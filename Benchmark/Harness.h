@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace Benchmark
+{
+	// Settings of one command line run, every structure is run against every
+	// workload `repeat` times. See PrintHarnessUsage() for the flags.
+	struct HarnessOptions
+	{
+		std::vector<std::string> structures{ "skiplist" };
+		std::vector<char> workloads{ 'A' };
+
+		uint32_t records = 100'000;
+		uint32_t operations = 100'000;
+		uint32_t warmup = 10'000;
+		uint32_t repeat = 3;
+		uint32_t key_size = 16;
+		uint32_t value_size = 100;
+		double theta = 0.99;
+		uint64_t seed = 42;
+
+		std::string format = "table";	// table, csv or json
+		std::string output{};			// empty writes to stdout
+		bool help = false;
+	};
+
+	struct HarnessResult
+	{
+		std::string structure;
+		char workload = 'A';
+		uint32_t repetition = 0;
+		uint64_t load_ns = 0;
+		uint64_t run_ns = 0;
+		uint64_t hits = 0;			// keys found by reads plus entries returned by scans
+	};
+
+	// Returns false with a message in error when argv cannot be parsed.
+	bool ParseHarnessOptions(int argc, char** argv, HarnessOptions& options, std::string& error);
+	void PrintHarnessUsage(std::ostream& out, const char* program);
+
+	std::vector<HarnessResult> RunHarness(const HarnessOptions& options);
+	// Returns false when the output file cannot be written.
+	bool WriteHarnessResults(const HarnessOptions& options, const std::vector<HarnessResult>& results);
+
+	// Parse, run and report, the exit code for main().
+	int HarnessMain(int argc, char** argv);
+}
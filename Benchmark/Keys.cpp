@@ -1,6 +1,8 @@
 #include <Keys.h>
 #include <random>
 #include <cassert>
+#include <algorithm>
+#include <cmath>
 
 static inline std::string random_word(std::size_t min_len = 3, std::size_t max_len = 12) 
 {
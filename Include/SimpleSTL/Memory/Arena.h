@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+
+// Bump allocator that carves allocations out of large contiguous blocks.
+// Individual allocations are never freed, memory is returned in bulk with
+// reset() (back to the pinned position) or when the arena is destroyed.
+class Arena
+{
+public:
+	static constexpr size_t DefaultBlockSize = 1 << 20;
+
+	explicit Arena(size_t block_size = DefaultBlockSize) noexcept
+		:	m_block_size(block_size) { }
+
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	~Arena()
+	{
+		for (auto& b : m_blocks)
+			::operator delete(b.memory, std::align_val_t{ BlockAlign });
+	}
+
+	void* allocate(size_t bytes, size_t align)
+	{
+		assert(align <= BlockAlign && (align & (align - 1)) == 0);
+
+		std::byte* p = align_up(m_ptr, align);
+		if (p && p + bytes <= m_end)
+		{
+			m_ptr = p + bytes;
+			m_used += bytes;
+			return p;
+		}
+
+		// large requests get their own block so the current one is not wasted
+		if (bytes > m_block_size / 4)
+		{
+			m_used += bytes;
+			return new_block(bytes).memory;
+		}
+
+		Block& b = new_block(m_block_size);
+		m_ptr = b.memory + bytes;
+		m_end = b.memory + b.size;
+		m_used += bytes;
+		return b.memory;
+	}
+
+	// Makes sure the next `bytes` worth of allocations come out of one block,
+	// starting a new one when the current block has less room left.
+	void reserve(size_t bytes)
+	{
+		if (bytes == 0 || (m_ptr && m_ptr + bytes <= m_end))
+			return;
+
+		Block& b = new_block(bytes > m_block_size ? bytes : m_block_size);
+		m_ptr = b.memory;
+		m_end = b.memory + b.size;
+	}
+
+	// Marks the current position as the floor reset() rewinds to, everything
+	// allocated before the pin survives a reset.
+	void pin() noexcept
+	{
+		m_pin_blocks = m_blocks.size();
+		m_pin_ptr = m_ptr;
+		m_pin_end = m_end;
+		m_pin_used = m_used;
+	}
+
+	void reset() noexcept
+	{
+		while (m_blocks.size() > m_pin_blocks)
+		{
+			::operator delete(m_blocks.back().memory, std::align_val_t{ BlockAlign });
+			m_reserved -= m_blocks.back().size;
+			m_blocks.pop_back();
+		}
+
+		m_ptr = m_pin_ptr;
+		m_end = m_pin_end;
+		m_used = m_pin_used;
+	}
+
+	size_t bytes_reserved() const noexcept { return m_reserved; }
+	size_t bytes_used() const noexcept { return m_used; }
+
+	// Containers and node handles with live nodes in the arena register here.
+	// reset() is only safe while a single holder is left; allocator copies
+	// kept elsewhere, e.g. by whoever picked the block size, do not count.
+	void attach() noexcept { ++m_holders; }
+	void detach() noexcept
+	{
+		assert(m_holders > 0 && "detach without attach");
+		--m_holders;
+	}
+	size_t holders() const noexcept { return m_holders; }
+
+private:
+	static constexpr size_t BlockAlign = alignof(std::max_align_t);
+
+	struct Block
+	{
+		std::byte* memory = nullptr;
+		size_t size = 0;
+	};
+
+	static std::byte* align_up(std::byte* p, size_t align) noexcept
+	{
+		const auto v = reinterpret_cast<uintptr_t>(p);
+		return reinterpret_cast<std::byte*>((v + align - 1) & ~(uintptr_t)(align - 1));
+	}
+
+	Block& new_block(size_t bytes)
+	{
+		m_blocks.reserve(m_blocks.size() + 1);
+
+		auto* memory = static_cast<std::byte*>(::operator new(bytes, std::align_val_t{ BlockAlign }));
+		m_blocks.push_back({ memory, bytes });
+		m_reserved += bytes;
+		return m_blocks.back();
+	}
+
+private:
+	size_t				m_block_size = DefaultBlockSize;
+	std::vector<Block>	m_blocks{};
+	std::byte*			m_ptr = nullptr;
+	std::byte*			m_end = nullptr;
+	size_t				m_reserved = 0;
+	size_t				m_used = 0;
+
+	size_t				m_pin_blocks = 0;
+	std::byte*			m_pin_ptr = nullptr;
+	std::byte*			m_pin_end = nullptr;
+	size_t				m_pin_used = 0;
+
+	size_t				m_holders = 0;
+};
+
+
+// Standard allocator front-end for Arena. Rebound copies share the same arena,
+// deallocate is a no-op. Containers copy-constructed from one get a fresh arena.
+// Containers handed copies of one allocator share its arena and only rewind it
+// on clear() while no other container or node handle holds nodes in it, see
+// Arena::attach().
+template<class T>
+class ArenaAllocator
+{
+public:
+	using value_type = T;
+	using propagate_on_container_copy_assignment = std::false_type;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+	using is_always_equal = std::false_type;
+
+	ArenaAllocator()
+		:	m_arena(std::make_shared<Arena>()) { }
+
+	explicit ArenaAllocator(size_t block_size)
+		:	m_arena(std::make_shared<Arena>(block_size)) { }
+
+	// No moves: a moved-from allocator must keep the arena, the container it
+	// belongs to may still allocate through it.
+	ArenaAllocator(const ArenaAllocator&) noexcept = default;
+	ArenaAllocator& operator=(const ArenaAllocator&) noexcept = default;
+
+	template<class U>
+	ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+		:	m_arena(other.m_arena) { }
+
+	T* allocate(size_t n)
+	{
+		constexpr size_t align = alignof(T) > alignof(std::max_align_t) ? alignof(T) : alignof(std::max_align_t);
+		return static_cast<T*>(m_arena->allocate(n * sizeof(T), align));
+	}
+
+	void deallocate(T*, size_t) noexcept { }
+
+	ArenaAllocator select_on_container_copy_construction() const { return ArenaAllocator{}; }
+
+	Arena& arena() const noexcept { return *m_arena; }
+
+	friend bool operator==(const ArenaAllocator& a, const ArenaAllocator& b) noexcept
+	{
+		return &a.arena() == &b.arena();
+	}
+
+private:
+	template<class U>
+	friend class ArenaAllocator;
+
+	std::shared_ptr<Arena> m_arena;
+};
+
+
+template<class A>
+struct is_arena_allocator : std::false_type { };
+
+template<class T>
+struct is_arena_allocator<ArenaAllocator<T>> : std::true_type { };
+
+template<class A>
+inline constexpr bool is_arena_allocator_v = is_arena_allocator<A>::value;
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+
+namespace EpochDetail
+{
+	inline constexpr size_t MaxThreads = 128;
+
+	// Process wide thread numbering, so every EpochDomain can index its
+	// per-thread slots directly instead of registering threads one by one.
+	// Numbers are handed back when a thread exits and reused.
+	struct ThreadRegistry
+	{
+		std::mutex				mutex;
+		std::vector<bool>		used = std::vector<bool>(MaxThreads, false);
+		std::atomic<size_t>		high{ 0 };		// one past the largest number ever handed out
+
+		static ThreadRegistry& get()
+		{
+			static ThreadRegistry registry;
+			return registry;
+		}
+	};
+
+	struct ThreadIndex
+	{
+		size_t index;
+
+		ThreadIndex()
+		{
+			ThreadRegistry& r = ThreadRegistry::get();
+			std::lock_guard<std::mutex> lock(r.mutex);
+
+			size_t i = 0;
+			while (i < MaxThreads && r.used[i])
+				++i;
+			if (i == MaxThreads)
+				throw std::length_error("too many threads using EpochDomain");
+
+			r.used[i] = true;
+			if (i + 1 > r.high.load(std::memory_order_relaxed))
+				r.high.store(i + 1, std::memory_order_release);
+
+			index = i;
+		}
+
+		~ThreadIndex()
+		{
+			ThreadRegistry& r = ThreadRegistry::get();
+			std::lock_guard<std::mutex> lock(r.mutex);
+			r.used[index] = false;
+		}
+	};
+
+	inline size_t thread_index()
+	{
+		static thread_local ThreadIndex t;
+		return t.index;
+	}
+}
+
+
+// Epoch based reclamation. Readers pin the domain for the duration of a
+// traversal; memory unlinked by a writer is retire()d and only freed once the
+// global epoch moved two steps past the retirement, at which point every
+// thread that could still hold a pointer to it has unpinned.
+//
+// Pinning is one atomic exchange on a thread private cache line and nests
+// freely. Retired memory is queued on the retiring thread and collected
+// by that thread every CollectInterval retirements, so a thread that stops
+// retiring leaves its last batch for the destructor.
+class EpochDomain
+{
+public:
+	static constexpr size_t MaxThreads = EpochDetail::MaxThreads;
+	static constexpr size_t CollectInterval = 64;
+
+	using deleter_type = void (*)(void* context, void* p);
+
+	class Guard
+	{
+	public:
+		Guard() noexcept = default;
+		Guard(Guard&& other) noexcept
+			: m_domain(std::exchange(other.m_domain, nullptr)) { }
+
+		Guard& operator=(Guard&& other) noexcept
+		{
+			if (this != &other)
+			{
+				release();
+				m_domain = std::exchange(other.m_domain, nullptr);
+			}
+			return *this;
+		}
+
+		Guard(const Guard&) = delete;
+		Guard& operator=(const Guard&) = delete;
+
+		~Guard()
+		{
+			release();
+		}
+
+		void release() noexcept
+		{
+			if (m_domain)
+				std::exchange(m_domain, nullptr)->unpin();
+		}
+
+	private:
+		friend class EpochDomain;
+
+		explicit Guard(const EpochDomain* domain) noexcept
+			: m_domain(domain) { }
+
+		const EpochDomain* m_domain = nullptr;
+	};
+
+	EpochDomain() = default;
+
+	EpochDomain(const EpochDomain&) = delete;
+	EpochDomain& operator=(const EpochDomain&) = delete;
+
+	~EpochDomain()
+	{
+		reclaim_all();
+	}
+
+	uint64_t epoch() const noexcept { return m_epoch.load(std::memory_order_relaxed); }
+
+	// May throw std::length_error the first time it is called from a thread
+	// when MaxThreads threads already hold a number.
+	[[nodiscard]] Guard pin() const
+	{
+		// A seq_cst exchange rather than store + fence: it keeps the loads of
+		// the pinned section from moving above it and, being a read-modify-
+		// write, extends the release sequence of the previous unpin, so an
+		// advancing thread that reads the new epoch still synchronizes with
+		// everything read before that unpin.
+		Slot& s = m_slots[EpochDetail::thread_index()];
+		if (s.nesting++ == 0)
+			s.state.exchange(m_epoch.load(std::memory_order_acquire), std::memory_order_seq_cst);
+
+		return Guard(this);
+	}
+
+	// p must already be unreachable for threads that pin from now on. The
+	// caller must hold a pin.
+	void retire(void* p, deleter_type deleter, void* context)
+	{
+		Slot& s = m_slots[EpochDetail::thread_index()];
+		assert(s.nesting > 0 && "retire outside of a pinned section");
+
+		s.retired.push_back({ p, deleter, context, m_epoch.load(std::memory_order_seq_cst) });
+		if (s.retired.size() % CollectInterval == 0)
+			collect(s);
+	}
+
+	// Frees everything retired so far. No thread may be pinned.
+	void reclaim_all() noexcept
+	{
+		const size_t high = EpochDetail::ThreadRegistry::get().high.load(std::memory_order_acquire);
+		for (size_t i = 0; i < high; ++i)
+		{
+			Slot& s = m_slots[i];
+			assert(s.state.load(std::memory_order_relaxed) == 0 && "reclaim_all while pinned");
+
+			for (const Retired& r : s.retired)
+				r.deleter(r.context, r.p);
+			s.retired.clear();
+		}
+	}
+
+	// Retired but not yet freed, summed over all threads. Only exact while no
+	// thread is retiring.
+	size_t pending() const noexcept
+	{
+		size_t total = 0;
+		const size_t high = EpochDetail::ThreadRegistry::get().high.load(std::memory_order_acquire);
+		for (size_t i = 0; i < high; ++i)
+			total += m_slots[i].retired.size();
+		return total;
+	}
+
+private:
+	struct Retired
+	{
+		void*			p;
+		deleter_type	deleter;
+		void*			context;
+		uint64_t		epoch;
+	};
+
+	// state is 0 while the thread is not pinned, else the epoch it pinned at.
+	struct alignas(64) Slot
+	{
+		std::atomic<uint64_t>	state{ 0 };
+		uint32_t				nesting = 0;
+		std::vector<Retired>	retired;
+	};
+
+	void unpin() const noexcept
+	{
+		Slot& s = m_slots[EpochDetail::thread_index()];
+		assert(s.nesting > 0);
+
+		if (--s.nesting == 0)
+			s.state.store(0, std::memory_order_release);
+	}
+
+	// Moves the global epoch one step if every pinned thread has seen the
+	// current one. Returns the epoch after the attempt.
+	uint64_t try_advance() noexcept
+	{
+		uint64_t e = m_epoch.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		const size_t high = EpochDetail::ThreadRegistry::get().high.load(std::memory_order_acquire);
+		for (size_t i = 0; i < high; ++i)
+		{
+			const uint64_t state = m_slots[i].state.load(std::memory_order_acquire);
+			if (state != 0 && state != e)
+				return e;
+		}
+
+		if (m_epoch.compare_exchange_strong(e, e + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+			return e + 1;
+
+		return e;
+	}
+
+	void collect(Slot& s)
+	{
+		const uint64_t e = try_advance();
+
+		size_t kept = 0;
+		for (size_t i = 0; i < s.retired.size(); ++i)
+		{
+			const Retired r = s.retired[i];
+			if (r.epoch + 2 <= e)
+				r.deleter(r.context, r.p);
+			else
+				s.retired[kept++] = r;
+		}
+		s.retired.resize(kept);
+	}
+
+private:
+	mutable Slot						m_slots[MaxThreads];
+	alignas(64) std::atomic<uint64_t>	m_epoch{ 1 };
+};
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+// Read-only mapping of a whole file. The pages stay mapped until the object
+// is destroyed, views handed out by data() / view() live as long as it does.
+// Opening fails with std::system_error.
+class MappedFile
+{
+public:
+	MappedFile() noexcept = default;
+
+	explicit MappedFile(const std::string& path)
+	{
+#if defined(_WIN32)
+		HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			throw std::system_error((int)::GetLastError(), std::system_category(), "open " + path);
+
+		LARGE_INTEGER size{};
+		if (!::GetFileSizeEx(file, &size))
+		{
+			const DWORD err = ::GetLastError();
+			::CloseHandle(file);
+			throw std::system_error((int)err, std::system_category(), "stat " + path);
+		}
+
+		m_size = static_cast<size_t>(size.QuadPart);
+		if (m_size != 0)
+		{
+			HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!mapping)
+			{
+				const DWORD err = ::GetLastError();
+				::CloseHandle(file);
+				throw std::system_error((int)err, std::system_category(), "map " + path);
+			}
+
+			m_data = static_cast<const std::byte*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+			const DWORD err = ::GetLastError();
+			::CloseHandle(mapping);
+			if (!m_data)
+			{
+				::CloseHandle(file);
+				throw std::system_error((int)err, std::system_category(), "map " + path);
+			}
+		}
+
+		::CloseHandle(file);
+#else
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			throw std::system_error(errno, std::generic_category(), "open " + path);
+
+		struct stat st{};
+		if (::fstat(fd, &st) != 0)
+		{
+			const int err = errno;
+			::close(fd);
+			throw std::system_error(err, std::generic_category(), "stat " + path);
+		}
+
+		m_size = static_cast<size_t>(st.st_size);
+		if (m_size != 0)
+		{
+			void* p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (p == MAP_FAILED)
+			{
+				const int err = errno;
+				::close(fd);
+				throw std::system_error(err, std::generic_category(), "mmap " + path);
+			}
+
+			m_data = static_cast<const std::byte*>(p);
+		}
+
+		::close(fd);
+#endif
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	MappedFile(MappedFile&& other) noexcept
+		: m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) { }
+
+	MappedFile& operator=(MappedFile&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		unmap();
+		m_data = std::exchange(other.m_data, nullptr);
+		m_size = std::exchange(other.m_size, 0);
+		return *this;
+	}
+
+	~MappedFile()
+	{
+		unmap();
+	}
+
+	const std::byte* data() const noexcept { return m_data; }
+	size_t size() const noexcept { return m_size; }
+
+	std::string_view view() const noexcept
+	{
+		return { reinterpret_cast<const char*>(m_data), m_size };
+	}
+
+private:
+	void unmap() noexcept
+	{
+		if (!m_data)
+			return;
+
+#if defined(_WIN32)
+		::UnmapViewOfFile(m_data);
+#else
+		::munmap(const_cast<std::byte*>(m_data), m_size);
+#endif
+		m_data = nullptr;
+		m_size = 0;
+	}
+
+	const std::byte*	m_data = nullptr;
+	size_t				m_size = 0;
+};
@@ -0,0 +1,546 @@
+#pragma once
+
+#include <SimpleSTL/Storage/MappedFile.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+
+// On disk layout, all integers little endian:
+//
+//	data block		entries, restart offsets (u32 each), restart count (u32)
+//	entry			varint shared, varint unshared, varint value size,
+//					key bytes [shared, shared + unshared), value bytes
+//	index			per data block: varint key size, last key of the block,
+//					u64 block offset, u64 block size
+//	footer			u64 index offset, u64 index size, u64 entry count, u64 magic
+//
+// Keys are prefix compressed against the previous key of the same block. Every
+// restart_interval entries the full key is stored again (shared == 0) and its
+// offset recorded, so a block is searched by bisecting the restart keys and
+// scanning at most restart_interval entries from there.
+namespace SortedTableFormat
+{
+	inline constexpr uint64_t magic = 0x5453656c706d6953ull;	// "SimpleST"
+	inline constexpr size_t footer_size = 32;
+
+	inline void put_fixed32(std::string& out, uint32_t v)
+	{
+		char buf[4];
+		for (int i = 0; i < 4; ++i)
+			buf[i] = (char)(v >> (8 * i));
+		out.append(buf, 4);
+	}
+
+	inline void put_fixed64(std::string& out, uint64_t v)
+	{
+		char buf[8];
+		for (int i = 0; i < 8; ++i)
+			buf[i] = (char)(v >> (8 * i));
+		out.append(buf, 8);
+	}
+
+	inline void put_varint(std::string& out, uint64_t v)
+	{
+		char buf[10];
+		int n = 0;
+		while (v >= 0x80)
+		{
+			buf[n++] = (char)(v | 0x80);
+			v >>= 7;
+		}
+		buf[n++] = (char)v;
+		out.append(buf, n);
+	}
+
+	inline uint32_t get_fixed32(const char* p) noexcept
+	{
+		uint32_t v = 0;
+		for (int i = 0; i < 4; ++i)
+			v |= (uint32_t)(unsigned char)p[i] << (8 * i);
+		return v;
+	}
+
+	inline uint64_t get_fixed64(const char* p) noexcept
+	{
+		uint64_t v = 0;
+		for (int i = 0; i < 8; ++i)
+			v |= (uint64_t)(unsigned char)p[i] << (8 * i);
+		return v;
+	}
+
+	// Returns nullptr when the varint runs past limit.
+	inline const char* get_varint(const char* p, const char* limit, uint64_t& v) noexcept
+	{
+		v = 0;
+		for (int shift = 0; shift < 64 && p < limit; shift += 7)
+		{
+			const uint64_t byte = (unsigned char)*p++;
+			v |= (byte & 0x7F) << shift;
+			if (!(byte & 0x80))
+				return p;
+		}
+		return nullptr;
+	}
+
+	struct Entry
+	{
+		uint64_t	shared = 0;
+		uint64_t	unshared = 0;
+		uint64_t	value_size = 0;
+		const char*	key = nullptr;		// the unshared part
+		const char*	value = nullptr;
+		const char*	next = nullptr;
+	};
+
+	inline bool decode_entry(const char* p, const char* limit, Entry& e) noexcept
+	{
+		if (!(p = get_varint(p, limit, e.shared)) ||
+			!(p = get_varint(p, limit, e.unshared)) ||
+			!(p = get_varint(p, limit, e.value_size)))
+			return false;
+
+		if ((uint64_t)(limit - p) < e.unshared || (uint64_t)(limit - p) - e.unshared < e.value_size)
+			return false;
+
+		e.key = p;
+		e.value = p + e.unshared;
+		e.next = e.value + e.value_size;
+		return true;
+	}
+
+	// A data block as the index describes it, pointers into the mapping.
+	struct Block
+	{
+		std::string_view	last_key;
+		const char*			data = nullptr;
+		const char*			restarts = nullptr;
+		uint32_t			restart_count = 0;
+	};
+}
+
+
+// Streams strictly increasing (bytewise) keys into a sorted table file. Blocks
+// are assembled in memory and written whole, finish() appends the index and
+// footer. A writer destroyed before finish() leaves an unreadable file.
+class SortedTableWriter
+{
+public:
+	explicit SortedTableWriter(const std::string& path, size_t block_size = 4096, int restart_interval = 16)
+		: m_block_size(block_size), m_restart_interval(restart_interval < 1 ? 1 : restart_interval)
+	{
+		m_file = std::fopen(path.c_str(), "wb");
+		if (!m_file)
+			throw std::system_error(errno, std::generic_category(), "open " + path);
+
+		m_block.reserve(block_size + block_size / 4);
+	}
+
+	SortedTableWriter(const SortedTableWriter&) = delete;
+	SortedTableWriter& operator=(const SortedTableWriter&) = delete;
+
+	~SortedTableWriter()
+	{
+		if (m_file)
+			std::fclose(m_file);
+	}
+
+	uint64_t entry_count() const noexcept { return m_entries; }
+
+	// Bytes written so far, the final file size once finish() returned.
+	uint64_t file_size() const noexcept { return m_offset; }
+
+	void add(std::string_view key, std::string_view value)
+	{
+		assert(m_file && "add after finish");
+		assert((m_entries == 0 || m_last_key < key) && "keys must be strictly increasing");
+
+		size_t shared = 0;
+		if (m_block.empty())
+			m_counter = 0;
+		else if (m_counter < m_restart_interval)
+		{
+			const size_t limit = std::min(m_last_key.size(), key.size());
+			while (shared < limit && m_last_key[shared] == key[shared])
+				++shared;
+		}
+		else
+		{
+			m_restarts.push_back((uint32_t)m_block.size());
+			m_counter = 0;
+		}
+
+		SortedTableFormat::put_varint(m_block, shared);
+		SortedTableFormat::put_varint(m_block, key.size() - shared);
+		SortedTableFormat::put_varint(m_block, value.size());
+		m_block.append(key.data() + shared, key.size() - shared);
+		m_block.append(value.data(), value.size());
+
+		m_last_key.resize(shared);
+		m_last_key.append(key.data() + shared, key.size() - shared);
+		++m_counter;
+		++m_entries;
+
+		if (m_block.size() >= m_block_size)
+			flush_block();
+	}
+
+	void finish()
+	{
+		assert(m_file && "finish called twice");
+
+		flush_block();
+
+		const uint64_t index_offset = m_offset;
+		write(m_index);
+
+		std::string footer;
+		SortedTableFormat::put_fixed64(footer, index_offset);
+		SortedTableFormat::put_fixed64(footer, m_index.size());
+		SortedTableFormat::put_fixed64(footer, m_entries);
+		SortedTableFormat::put_fixed64(footer, SortedTableFormat::magic);
+		write(footer);
+
+		const bool failed = std::fclose(m_file) != 0;
+		m_file = nullptr;
+		if (failed)
+			throw std::system_error(errno, std::generic_category(), "close sorted table");
+	}
+
+private:
+	void flush_block()
+	{
+		if (m_block.empty())
+			return;
+
+		for (uint32_t r : m_restarts)
+			SortedTableFormat::put_fixed32(m_block, r);
+		SortedTableFormat::put_fixed32(m_block, (uint32_t)m_restarts.size());
+
+		SortedTableFormat::put_varint(m_index, m_last_key.size());
+		m_index.append(m_last_key);
+		SortedTableFormat::put_fixed64(m_index, m_offset);
+		SortedTableFormat::put_fixed64(m_index, m_block.size());
+
+		write(m_block);
+
+		m_block.clear();
+		m_restarts.assign(1, 0);
+		m_counter = 0;
+	}
+
+	void write(std::string_view bytes)
+	{
+		if (std::fwrite(bytes.data(), 1, bytes.size(), m_file) != bytes.size())
+			throw std::system_error(errno, std::generic_category(), "write sorted table");
+
+		m_offset += bytes.size();
+	}
+
+private:
+	std::FILE*				m_file = nullptr;
+	size_t					m_block_size;
+	int						m_restart_interval;
+	int						m_counter = 0;
+	std::string				m_block;
+	std::vector<uint32_t>	m_restarts{ 0 };
+	std::string				m_last_key;
+	std::string				m_index;
+	uint64_t				m_offset = 0;
+	uint64_t				m_entries = 0;
+};
+
+
+// Writes every entry of an ordered container, walked front to back along its
+// bottom level, to a new sorted table. Keys and values must convert to
+// std::string_view and the container must order keys bytewise.
+template<class Container>
+uint64_t write_sorted_table(const Container& c, const std::string& path, size_t block_size = 4096, int restart_interval = 16)
+{
+	SortedTableWriter writer(path, block_size, restart_interval);
+	for (const auto& kv : c)
+		writer.add(std::string_view(kv.first), std::string_view(kv.second));
+
+	writer.finish();
+	return writer.file_size();
+}
+
+
+class SortedTable;
+
+// Yields pairs of views. The value points into the mapping; the key is
+// rebuilt in the iterator from its shared prefix, so it is only valid until
+// the iterator moves. Like a std::vector iterator it survives moving the
+// table and dangles once the table that owns the data is destroyed or
+// assigned to.
+class SortedTableIterator
+{
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = std::pair<std::string_view, std::string_view>;
+	using difference_type = std::ptrdiff_t;
+	using reference = value_type;
+
+	struct pointer
+	{
+		value_type kv;
+		const value_type* operator->() const noexcept { return &kv; }
+	};
+
+	SortedTableIterator() = default;
+
+	reference operator*() const noexcept { return { m_key, m_value }; }
+	pointer operator->() const noexcept { return { **this }; }
+
+	std::string_view key() const noexcept { return m_key; }
+	std::string_view value() const noexcept { return m_value; }
+
+	inline SortedTableIterator& operator++();
+	SortedTableIterator operator++(int)
+	{
+		SortedTableIterator tmp(*this);
+		++(*this);
+		return tmp;
+	}
+
+	friend bool operator==(const SortedTableIterator& a, const SortedTableIterator& b) noexcept
+	{
+		return a.m_entry == b.m_entry;
+	}
+	friend bool operator!=(const SortedTableIterator& a, const SortedTableIterator& b) noexcept
+	{
+		return !(a == b);
+	}
+
+private:
+	friend class SortedTable;
+
+	using Block = SortedTableFormat::Block;
+
+	const Block*		m_blocks = nullptr;	// the table's index, survives moving the table
+	size_t				m_block_count = 0;
+	size_t				m_block = 0;
+	const char*			m_entry = nullptr;	// nullptr at end
+	const char*			m_next = nullptr;
+	const char*			m_limit = nullptr;	// start of the restart array
+	std::string			m_key;
+	std::string_view	m_value;
+};
+
+
+// Read-only view of a sorted table file. Opening maps the file and decodes
+// only the block index; lookups bisect the index, then the restart points of
+// one block, and return views into the mapped pages. Throws std::system_error
+// when the file cannot be mapped and std::runtime_error when it is malformed.
+class SortedTable
+{
+public:
+	using key_type = std::string_view;
+	using mapped_type = std::string_view;
+	using value_type = std::pair<std::string_view, std::string_view>;
+	using size_type = size_t;
+	using iterator = SortedTableIterator;
+	using const_iterator = SortedTableIterator;
+
+	SortedTable() = default;
+
+	explicit SortedTable(const std::string& path)
+		: m_file(path)
+	{
+		const std::string_view data = m_file.view();
+		if (data.size() < SortedTableFormat::footer_size)
+			corrupt();
+
+		const char* footer = data.data() + data.size() - SortedTableFormat::footer_size;
+		const uint64_t index_offset = SortedTableFormat::get_fixed64(footer);
+		const uint64_t index_size = SortedTableFormat::get_fixed64(footer + 8);
+		m_size = (size_t)SortedTableFormat::get_fixed64(footer + 16);
+		if (SortedTableFormat::get_fixed64(footer + 24) != SortedTableFormat::magic)
+			corrupt();
+
+		const uint64_t body = data.size() - SortedTableFormat::footer_size;
+		if (index_offset > body || index_size > body - index_offset)
+			corrupt();
+
+		const char* p = data.data() + index_offset;
+		const char* limit = p + index_size;
+		while (p < limit)
+		{
+			uint64_t key_size = 0;
+			if (!(p = SortedTableFormat::get_varint(p, limit, key_size)) || (uint64_t)(limit - p) < key_size + 16)
+				corrupt();
+
+			Block b;
+			b.last_key = std::string_view(p, (size_t)key_size);
+			p += key_size;
+			const uint64_t offset = SortedTableFormat::get_fixed64(p);
+			const uint64_t size = SortedTableFormat::get_fixed64(p + 8);
+			p += 16;
+
+			if (offset > index_offset || size > index_offset - offset || size < 4)
+				corrupt();
+
+			b.data = data.data() + offset;
+			const uint32_t restarts = SortedTableFormat::get_fixed32(b.data + size - 4);
+			if (restarts == 0 || (uint64_t)restarts > (size - 4) / 4)
+				corrupt();
+
+			b.restarts = b.data + size - 4 - 4 * (uint64_t)restarts;
+			b.restart_count = restarts;
+			m_blocks.push_back(b);
+		}
+	}
+
+	SortedTable(SortedTable&&) noexcept = default;
+	SortedTable& operator=(SortedTable&&) noexcept = default;
+
+	size_type size() const noexcept { return m_size; }
+	bool empty() const noexcept { return m_size == 0; }
+	size_t block_count() const noexcept { return m_blocks.size(); }
+	size_t file_size() const noexcept { return m_file.size(); }
+
+	iterator begin() const
+	{
+		iterator it;
+		if (!m_blocks.empty())
+			enter_block(it, 0, m_blocks[0].data);
+		return it;
+	}
+
+	iterator end() const noexcept { return iterator(); }
+
+	iterator lower_bound(std::string_view key) const
+	{
+		const auto b = std::lower_bound(m_blocks.begin(), m_blocks.end(), key,
+			[](const Block& block, std::string_view k) { return block.last_key < k; });
+		if (b == m_blocks.end())
+			return end();
+
+		const Block& block = *b;
+
+		// Last restart whose key is below the target, the entry we want is at
+		// or after it. Restart entries store their full key.
+		uint32_t lo = 0, hi = block.restart_count;
+		while (hi - lo > 1)
+		{
+			const uint32_t mid = lo + (hi - lo) / 2;
+			if (restart_key(block, mid) < key)
+				lo = mid;
+			else
+				hi = mid;
+		}
+
+		iterator it;
+		enter_block(it, (size_t)(b - m_blocks.begin()), block.data + restart_offset(block, lo));
+		while (it.m_entry && it.m_key < key)
+			++it;
+
+		return it;
+	}
+
+	iterator find(std::string_view key) const
+	{
+		iterator it = lower_bound(key);
+		if (it != end() && it.key() == key)
+			return it;
+
+		return end();
+	}
+
+	bool contains(std::string_view key) const
+	{
+		return find(key) != end();
+	}
+
+private:
+	friend class SortedTableIterator;
+
+	using Block = SortedTableFormat::Block;
+
+	[[noreturn]] static void corrupt()
+	{
+		throw std::runtime_error("malformed sorted table");
+	}
+
+	static uint32_t restart_offset(const Block& b, uint32_t i) noexcept
+	{
+		return SortedTableFormat::get_fixed32(b.restarts + 4 * (size_t)i);
+	}
+
+	static std::string_view restart_key(const Block& b, uint32_t i)
+	{
+		SortedTableFormat::Entry e;
+		if (!SortedTableFormat::decode_entry(b.data + restart_offset(b, i), b.restarts, e) || e.shared != 0)
+			corrupt();
+
+		return { e.key, (size_t)e.unshared };
+	}
+
+	// Positions it on the entry at p inside block b. The entry must be a
+	// restart point or the block start, both carry the full key.
+	void enter_block(iterator& it, size_t b, const char* p) const
+	{
+		it.m_blocks = m_blocks.data();
+		it.m_block_count = m_blocks.size();
+		it.m_block = b;
+		it.m_limit = m_blocks[b].restarts;
+		it.m_next = p;
+		it.m_key.clear();
+		decode(it);
+	}
+
+	// Decodes the entry at it.m_next, moving to the next block at the end of
+	// the current one and to end() after the last. Reads the blocks through
+	// the iterator, whose pointer stays put when the table is moved.
+	static void decode(iterator& it)
+	{
+		while (it.m_next >= it.m_limit)
+		{
+			if (++it.m_block >= it.m_block_count)
+			{
+				it.m_entry = nullptr;
+				it.m_key.clear();
+				it.m_value = {};
+				return;
+			}
+
+			it.m_next = it.m_blocks[it.m_block].data;
+			it.m_limit = it.m_blocks[it.m_block].restarts;
+			it.m_key.clear();
+		}
+
+		SortedTableFormat::Entry e;
+		if (!SortedTableFormat::decode_entry(it.m_next, it.m_limit, e) || e.shared > it.m_key.size())
+			corrupt();
+
+		it.m_entry = it.m_next;
+		it.m_key.resize((size_t)e.shared);
+		it.m_key.append(e.key, (size_t)e.unshared);
+		it.m_value = std::string_view(e.value, (size_t)e.value_size);
+		it.m_next = e.next;
+	}
+
+private:
+	MappedFile			m_file;
+	std::vector<Block>	m_blocks;
+	size_t				m_size = 0;
+};
+
+
+inline SortedTableIterator& SortedTableIterator::operator++()
+{
+	SortedTable::decode(*this);
+	return *this;
+}
@@ -0,0 +1,521 @@
+#pragma once
+
+#include <SimpleSTL/Memory/Arena.h>
+#include <SimpleSTL/Types/SkipListHeight.h>
+
+#include <cassert>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+
+template<class NodePtr>
+class ByteSkipListIterator
+{
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = std::pair<std::string_view, std::string_view>;
+	using difference_type = std::ptrdiff_t;
+	using reference = value_type;
+
+	struct pointer
+	{
+		value_type kv;
+		const value_type* operator->() const noexcept { return &kv; }
+	};
+
+	ByteSkipListIterator() noexcept = default;
+	explicit ByteSkipListIterator(NodePtr n) noexcept
+		:	m_node(n) { }
+
+	reference operator*() const noexcept { return { m_node->key(), m_node->value() }; }
+	pointer operator->() const noexcept { return { **this }; }
+
+	ByteSkipListIterator& operator++() noexcept
+	{
+		m_node = m_node->next[0];
+		return *this;
+	}
+	ByteSkipListIterator operator++(int) noexcept
+	{
+		ByteSkipListIterator tmp(*this);
+		++(*this);
+		return tmp;
+	}
+
+	friend bool operator==(const ByteSkipListIterator& a, const ByteSkipListIterator& b) noexcept
+	{
+		return a.m_node == b.m_node;
+	}
+	friend bool operator!=(const ByteSkipListIterator& a, const ByteSkipListIterator& b) noexcept
+	{
+		return !(a == b);
+	}
+
+	NodePtr node() const noexcept { return m_node; }
+
+private:
+	NodePtr m_node = nullptr;
+};
+
+
+// SkipList for byte string keys and values. Both are copied into the node
+// allocation right after the tower, so an entry costs exactly one allocation
+// and lookups compare against memory that sits next to the links.
+template<
+	class Compare = std::less<std::string_view>,
+	class Alloc = std::allocator<std::byte>,
+	int MaxLevel = 12,
+	int PNumerator = 1,
+	int PDenominator = 4,
+	class HeightPolicy = XorShiftHeight
+>
+class ByteSkipList
+{
+private:
+	static_assert(MaxLevel >= 2, "Max level must be more or equal than 2");
+	static_assert(PNumerator > 0 && PDenominator > 0 && PNumerator < PDenominator, "P must be 0 < P < 1");
+
+public:
+	using key_type = std::string_view;
+	using mapped_type = std::string_view;
+	using value_type = std::pair<std::string_view, std::string_view>;
+	using size_type = size_t;
+	using diff_type = std::ptrdiff_t;
+	using key_compare = Compare;
+	using allocator_type = Alloc;
+
+private:
+	using byte_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::byte>;
+	using byte_traits = std::allocator_traits<byte_alloc>;
+
+	static constexpr bool arena_nodes = is_arena_allocator_v<byte_alloc>;
+
+	// Same rule as SkipList, clear() only rewinds an arena no other holder
+	// has nodes in.
+	bool owns_arena() const noexcept { return m_byte_alloc.arena().holders() == 1; }
+
+	struct Node
+	{
+		uint32_t key_size = 0;
+		uint32_t value_size = 0;
+		uint8_t height = 1;
+		Node* next[1];
+
+		char* data() noexcept { return reinterpret_cast<char*>(next + height); }
+		const char* data() const noexcept { return reinterpret_cast<const char*>(next + height); }
+
+		std::string_view key() const noexcept { return { data(), key_size }; }
+		std::string_view value() const noexcept { return { data() + key_size, value_size }; }
+	};
+
+	static constexpr size_t node_bytes(uint8_t height, size_t key_size, size_t value_size) noexcept
+	{
+		return sizeof(Node) + (static_cast<size_t>(height) - 1) * sizeof(Node*) + key_size + value_size;
+	}
+
+	static constexpr size_t node_bytes(const Node* n) noexcept
+	{
+		return node_bytes(n->height, n->key_size, n->value_size);
+	}
+
+	Node* create_node(std::string_view key, std::string_view value, uint8_t height)
+	{
+		assert(height >= 1 && height <= MaxLevel);
+		if (key.size() > std::numeric_limits<uint32_t>::max() || value.size() > std::numeric_limits<uint32_t>::max())
+			throw std::length_error("ByteSkipList key or value longer than 4 GiB");
+
+		const size_t bytes = node_bytes(height, key.size(), value.size());
+		std::byte* memory = byte_traits::allocate(m_byte_alloc, bytes);
+
+		Node* n = ::new (static_cast<void*>(memory)) Node();
+		n->key_size = static_cast<uint32_t>(key.size());
+		n->value_size = static_cast<uint32_t>(value.size());
+		n->height = height;
+		for (size_t i = 0; i < height; ++i)
+		{
+			n->next[i] = nullptr;
+		}
+
+		if (!key.empty())
+			std::memcpy(n->data(), key.data(), key.size());
+		if (!value.empty())
+			std::memcpy(n->data() + key.size(), value.data(), value.size());
+
+		return n;
+	}
+
+	void destroy_node(Node* n) noexcept
+	{
+		if (!n)
+			return;
+
+		byte_traits::deallocate(m_byte_alloc, reinterpret_cast<std::byte*>(n), node_bytes(n));
+	}
+
+	static constexpr bool key_less(const Compare& comp, std::string_view a, std::string_view b)
+	{
+		return comp(a, b);
+	}
+
+	static constexpr bool key_eq(const Compare& comp, std::string_view a, std::string_view b)
+	{
+		return !comp(a, b) && !comp(b, a);
+	}
+
+public:
+	using iterator = ByteSkipListIterator<const Node*>;
+	using const_iterator = iterator;
+
+	ByteSkipList()
+		: ByteSkipList(Compare{}, Alloc{}) { }
+
+	explicit ByteSkipList(const Compare& comp, const Alloc& alloc = Alloc{})
+		: m_comp(comp), m_alloc(alloc), m_byte_alloc(alloc)
+	{
+		ini_head();
+	}
+
+	ByteSkipList(const ByteSkipList& other)
+		: m_comp(other.m_comp),
+		m_alloc(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.m_alloc)),
+		m_byte_alloc(m_alloc)
+	{
+		ini_head();
+		try
+		{
+			copy_nodes(other);
+		}
+		catch (...)
+		{
+			clear();
+			destroy_head();
+			throw;
+		}
+	}
+
+	ByteSkipList& operator=(const ByteSkipList& other)
+	{
+		if (this == &other)
+			return *this;
+
+		clear();
+		if constexpr (std::allocator_traits<Alloc>::propagate_on_container_copy_assignment::value)
+		{
+			destroy_head();
+			m_alloc = other.m_alloc;
+			m_byte_alloc = byte_alloc(m_alloc);
+		}
+		m_comp = other.m_comp;
+
+		if (!m_head)
+			ini_head();
+
+		copy_nodes(other);
+		return *this;
+	}
+
+	ByteSkipList(ByteSkipList&& other) noexcept
+		: m_comp(std::move(other.m_comp)),
+		m_alloc(std::move(other.m_alloc)),
+		m_byte_alloc(std::move(other.m_byte_alloc)),
+		m_head(other.m_head),
+		m_level(other.m_level),
+		m_size(other.m_size),
+		m_bytes(other.m_bytes),
+		m_height(std::move(other.m_height))
+	{
+		other.m_head = nullptr;
+		other.m_level = 1;
+		other.m_size = 0;
+		other.m_bytes = 0;
+	}
+
+	ByteSkipList& operator=(ByteSkipList&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		clear();
+		destroy_head();
+
+		if constexpr (std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value)
+		{
+			m_alloc = std::move(other.m_alloc);
+			m_byte_alloc = std::move(other.m_byte_alloc);
+		}
+
+		m_comp = std::move(other.m_comp);
+		m_head = other.m_head;
+		m_level = other.m_level;
+		m_size = other.m_size;
+		m_bytes = other.m_bytes;
+		m_height = std::move(other.m_height);
+
+		other.m_head = nullptr;
+		other.m_level = 1;
+		other.m_size = 0;
+		other.m_bytes = 0;
+		return *this;
+	}
+
+	~ByteSkipList()
+	{
+		clear();
+		destroy_head();
+	}
+
+	allocator_type get_allocator() const noexcept { return m_alloc; }
+	key_compare key_comp() const { return m_comp; }
+
+	bool empty() const noexcept { return m_size == 0; }
+	size_type size() const noexcept { return m_size; }
+
+	// Bytes held by entry nodes, links and inline key/value data included.
+	size_type bytes() const noexcept { return m_bytes; }
+
+	iterator begin() const noexcept { return iterator(m_head->next[0]); }
+	iterator end() const noexcept { return iterator(nullptr); }
+	iterator cbegin() const noexcept { return begin(); }
+	iterator cend() const noexcept { return end(); }
+
+	void clear() noexcept
+	{
+		if (!m_head)
+			return;
+
+		if constexpr (arena_nodes)
+		{
+			if (owns_arena())
+				m_byte_alloc.arena().reset();
+		}
+		else
+		{
+			Node* cur = m_head->next[0];
+			while (cur)
+			{
+				Node* nxt = cur->next[0];
+				destroy_node(cur);
+				cur = nxt;
+			}
+		}
+
+		for (size_t i = 0; i < MaxLevel; ++i)
+			m_head->next[i] = nullptr;
+
+		m_level = 1;
+		m_size = 0;
+		m_bytes = 0;
+	}
+
+	std::pair<iterator, bool> insert(std::string_view key, std::string_view value) { return emplace_impl(key, value, false); }
+	std::pair<iterator, bool> insert(const value_type& kv) { return emplace_impl(kv.first, kv.second, false); }
+
+	// Values are stored inline, so a differently sized value replaces the node.
+	std::pair<iterator, bool> insert_or_assign(std::string_view key, std::string_view value) { return emplace_impl(key, value, true); }
+
+	std::pair<iterator, bool> erase(std::string_view key) { return erase_impl(key); }
+
+	iterator find(std::string_view key) const noexcept
+	{
+		const Node* x = find_ge(key);
+		if (x && key_eq(m_comp, x->key(), key))
+			return iterator(x);
+
+		return end();
+	}
+
+	bool contains(std::string_view key) const noexcept
+	{
+		return find(key) != end();
+	}
+
+	iterator lower_bound(std::string_view key) const noexcept
+	{
+		return iterator(find_ge(key));
+	}
+
+private:
+	void ini_head()
+	{
+		m_head = create_node({}, {}, (uint8_t)(MaxLevel));
+		if constexpr (arena_nodes)
+		{
+			m_byte_alloc.arena().pin();
+			m_byte_alloc.arena().attach();
+		}
+
+		m_level = 1;
+		m_size = 0;
+		m_bytes = 0;
+	}
+
+	void destroy_head() noexcept
+	{
+		if (!m_head)
+			return;
+
+		destroy_node(m_head);
+		m_head = nullptr;
+		if constexpr (arena_nodes)
+			m_byte_alloc.arena().detach();
+	}
+
+	const Node* find_ge(std::string_view key) const noexcept
+	{
+		const Node* x = m_head;
+		for (int i = (int)(m_level) - 1; i >= 0; --i)
+		{
+			while (x->next[i] && key_less(m_comp, x->next[i]->key(), key))
+				x = x->next[i];
+		}
+
+		return x->next[0];
+	}
+
+	// Appends copies of other's nodes with their heights unchanged, linked in
+	// one pass through a per-level tail array. The list must be empty.
+	void copy_nodes(const ByteSkipList& other)
+	{
+		assert(m_size == 0);
+		if (!other.m_head)
+			return;
+
+		if constexpr (arena_nodes)
+			m_byte_alloc.arena().reserve(other.m_bytes + other.m_size * (alignof(std::max_align_t) - 1));
+
+		std::array<Node*, MaxLevel> tails{};
+		tails.fill(m_head);
+
+		for (const Node* x = other.m_head->next[0]; x; x = x->next[0])
+		{
+			Node* n = create_node(x->key(), x->value(), x->height);
+			for (size_t i = 0; i < n->height; ++i)
+			{
+				tails[i]->next[i] = n;
+				tails[i] = n;
+			}
+
+			if (n->height > m_level)
+				m_level = n->height;
+
+			++m_size;
+			m_bytes += node_bytes(n);
+		}
+	}
+
+	uint8_t random_height(std::string_view key)
+	{
+		return m_height.template height<MaxLevel, PNumerator, PDenominator>(key);
+	}
+
+	std::pair<iterator, bool> emplace_impl(std::string_view key, std::string_view value, bool assign)
+	{
+		std::array<Node*, MaxLevel> update{};
+		Node* x = m_head;
+
+		for (int i = (int)(m_level) - 1; i >= 0; --i)
+		{
+			while (x->next[i] && key_less(m_comp, x->next[i]->key(), key))
+				x = x->next[i];
+
+			update[i] = x;
+		}
+
+		x = x->next[0];
+		if (x && key_eq(m_comp, x->key(), key))
+		{
+			if (!assign)
+				return { iterator(x), false };
+
+			if (x->value_size == value.size())
+			{
+				if (!value.empty())
+					std::memcpy(x->data() + x->key_size, value.data(), value.size());
+				return { iterator(x), false };
+			}
+
+			Node* n = create_node(key, value, x->height);
+			for (size_t i = 0; i < x->height; ++i)
+			{
+				n->next[i] = x->next[i];
+				update[i]->next[i] = n;
+			}
+
+			m_bytes += node_bytes(n);
+			m_bytes -= node_bytes(x);
+			destroy_node(x);
+			return { iterator(n), false };
+		}
+
+		uint8_t h = random_height(key);
+		if (h > m_level)
+		{
+			for (size_t i = m_level; i < h; ++i)
+				update[i] = m_head;
+
+			m_level = h;
+		}
+
+		Node* n = create_node(key, value, h);
+
+		for (size_t i = 0; i < h; ++i)
+		{
+			n->next[i] = update[i]->next[i];
+			update[i]->next[i] = n;
+		}
+
+		++m_size;
+		m_bytes += node_bytes(n);
+		return { iterator(n), true };
+	}
+
+	std::pair<iterator, bool> erase_impl(std::string_view key)
+	{
+		std::array<Node*, MaxLevel> update{};
+		Node* x = m_head;
+
+		for (int i = (int)(m_level) - 1; i >= 0; --i)
+		{
+			while (x->next[i] && key_less(m_comp, x->next[i]->key(), key))
+				x = x->next[i];
+
+			update[i] = x;
+		}
+
+		x = x->next[0];
+		if (!x || !key_eq(m_comp, x->key(), key))
+			return { iterator(x), false };
+
+		for (size_t i = 0; i < x->height; ++i)
+			update[i]->next[i] = x->next[i];
+
+		Node* next = x->next[0];
+		m_bytes -= node_bytes(x);
+		destroy_node(x);
+		--m_size;
+
+		while (m_level > 1 && m_head->next[m_level - 1] == nullptr)
+			--m_level;
+
+		return { iterator(next), true };
+	}
+
+private:
+	Compare		m_comp{};
+	Alloc		m_alloc{};
+	byte_alloc	m_byte_alloc{};
+	Node*		m_head = nullptr;
+	uint8_t		m_level = 1;
+	size_t		m_size = 0;
+	size_t		m_bytes = 0;
+	[[no_unique_address]] HeightPolicy m_height{};
+};
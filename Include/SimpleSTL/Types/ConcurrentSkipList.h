@@ -0,0 +1,509 @@
+#pragma once
+
+#include <SimpleSTL/Types/SkipList.h>
+#include <SimpleSTL/Memory/Epoch.h>
+
+#include <atomic>
+#include <cassert>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+
+template<class NodePtr, class ValueRef, class ValuePtr>
+class ConcurrentSkipListIterator
+{
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = std::remove_cv_t<std::remove_reference_t<ValueRef>>;
+	using difference_type = std::ptrdiff_t;
+	using pointer = ValuePtr;
+	using reference = ValueRef;
+
+	ConcurrentSkipListIterator() noexcept = default;
+	explicit ConcurrentSkipListIterator(NodePtr n) noexcept
+		:	m_node(n) { }
+
+	reference operator*() const noexcept { return m_node->kv; }
+	pointer operator->() const noexcept { return std::addressof(m_node->kv); }
+
+	ConcurrentSkipListIterator& operator++() noexcept
+	{
+		m_node = m_node->successor();
+		return *this;
+	}
+	ConcurrentSkipListIterator operator++(int) noexcept
+	{
+		ConcurrentSkipListIterator tmp(*this);
+		++(*this);
+		return tmp;
+	}
+
+	friend bool operator==(const ConcurrentSkipListIterator& a, const ConcurrentSkipListIterator& b) noexcept
+	{
+		return a.m_node == b.m_node;
+	}
+	friend bool operator!=(const ConcurrentSkipListIterator& a, const ConcurrentSkipListIterator& b) noexcept
+	{
+		return !(a == b);
+	}
+
+	NodePtr node() const noexcept { return m_node; }
+
+private:
+	NodePtr m_node = nullptr;
+};
+
+
+// Lock-free multi-writer skip list meant to be used as a shared memtable.
+// insert/erase/find/lower_bound/iteration may run concurrently from any number
+// of threads. Nodes are linked with CAS from level 0 upward, so a node becomes
+// visible to readers as soon as its level 0 link succeeds. clear(), the
+// destructor and moves are NOT thread-safe. Alloc must tolerate concurrent
+// allocate/deallocate calls (std::allocator does).
+//
+// erase marks the links of a node, top level first (the low pointer bit), then
+// unlinks it; the level 0 mark is the linearization point. Unlinked nodes are
+// retired to an EpochDomain and freed once no reader can still be on them.
+// Every operation pins internally, an iterator that outlives the call needs a
+// pin() guard held around its use when erases may run.
+template<
+	class Key,
+	class Value,
+	class Compare = std::less<Key>,
+	class Alloc = std::allocator<std::pair<const Key, Value>>,
+	int MaxLevel = 12,
+	int PNumerator = 1,
+	int PDenominator = 4
+>
+class ConcurrentSkipList
+{
+private:
+	static_assert(MaxLevel >= 2, "Max level must be more or equal than 2");
+	static_assert(PNumerator > 0 && PDenominator > 0 && PNumerator < PDenominator, "P must be 0 < P < 1");
+
+public:
+	using key_type = Key;
+	using mapped_type = Value;
+	using value_type = std::pair<const Key, Value>;
+	using size_type = size_t;
+	using diff_type = std::ptrdiff_t;
+	using key_compare = Compare;
+	using allocator_type = Alloc;
+
+private:
+	using byte_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::byte>;
+	using byte_traits = std::allocator_traits<byte_alloc>;
+
+	struct Node
+	{
+		value_type kv;
+		uint8_t height = 1;
+		std::atomic<uint8_t> owners{ 2 };	// the inserter and the eraser, last one out retires
+		std::atomic<Node*> next[1];
+
+		template<class T>
+		Node(T&& v, uint8_t h)
+			: kv(std::forward<T>(v)), height(h) { }
+
+		static bool is_marked(Node* p) noexcept { return reinterpret_cast<uintptr_t>(p) & 1; }
+		static Node* marked(Node* p) noexcept { return reinterpret_cast<Node*>(reinterpret_cast<uintptr_t>(p) | 1); }
+		static Node* unmarked(Node* p) noexcept { return reinterpret_cast<Node*>(reinterpret_cast<uintptr_t>(p) & ~uintptr_t{ 1 }); }
+
+		bool deleted() const noexcept { return is_marked(next[0].load(std::memory_order_acquire)); }
+
+		// Next node on level 0 that is not being erased.
+		Node* successor() const noexcept
+		{
+			Node* n = unmarked(next[0].load(std::memory_order_acquire));
+			while (n && n->deleted())
+				n = unmarked(n->next[0].load(std::memory_order_acquire));
+
+			return n;
+		}
+	};
+
+	static constexpr size_t node_bytes(uint8_t height) noexcept
+	{
+		return sizeof(Node) + (static_cast<size_t>(height) - 1) * sizeof(std::atomic<Node*>);
+	}
+
+	template<class T>
+	Node* create_node(T&& t, uint8_t height)
+	{
+		assert(height >= 1 && height <= MaxLevel);
+
+		const size_t bytes = node_bytes(height);
+		std::byte* memory = byte_traits::allocate(m_byte_alloc, bytes);
+
+		Node* n = nullptr;
+		try
+		{
+			n = ::new (static_cast<void*>(memory)) Node(std::forward<T>(t), height);
+			for (size_t i = 1; i < height; ++i)
+			{
+				::new (static_cast<void*>(&n->next[i])) std::atomic<Node*>(nullptr);
+			}
+			n->next[0].store(nullptr, std::memory_order_relaxed);
+		}
+		catch (...)
+		{
+			byte_traits::deallocate(m_byte_alloc, memory, bytes);
+			throw;
+		}
+
+		return n;
+	}
+
+	void destroy_node(Node* n) noexcept
+	{
+		if (!n)
+			return;
+
+		const size_t bytes = node_bytes(n->height);
+		auto* memory = reinterpret_cast<std::byte*>(n);
+
+		n->~Node();
+		byte_traits::deallocate(m_byte_alloc, memory, bytes);
+	}
+
+	static void reclaim_node(void* list, void* n) noexcept
+	{
+		static_cast<ConcurrentSkipList*>(list)->destroy_node(static_cast<Node*>(n));
+	}
+
+	// Drops one of the two owners of an erased node, the last one hands it
+	// to the epoch domain. Both only let go once they are done unlinking.
+	void release_node(Node* n)
+	{
+		if (n->owners.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			m_epoch.retire(n, &reclaim_node, this);
+	}
+
+	static constexpr bool key_less(const Compare& comp, const Key& a, const Key& b)
+	{
+		return comp(a, b);
+	}
+
+	static constexpr bool key_eq(const Compare& comp, const Key& a, const Key& b)
+	{
+		return !comp(a, b) && !comp(b, a);
+	}
+
+public:
+	using iterator = ConcurrentSkipListIterator<Node*, value_type&, value_type*>;
+	using const_iterator = ConcurrentSkipListIterator<const Node*, const value_type&, const value_type*>;
+	using guard_type = EpochDomain::Guard;
+
+	ConcurrentSkipList()
+		: ConcurrentSkipList(Compare{}, Alloc{}) { }
+
+	explicit ConcurrentSkipList(const Compare& comp, const Alloc& alloc = Alloc{})
+		: m_comp(comp), m_alloc(alloc), m_byte_alloc(alloc)
+	{
+		ini_head();
+	}
+
+	ConcurrentSkipList(const ConcurrentSkipList&) = delete;
+	ConcurrentSkipList& operator=(const ConcurrentSkipList&) = delete;
+
+	~ConcurrentSkipList()
+	{
+		clear();
+		destroy_node(m_head);
+		m_head = nullptr;
+	}
+
+	// Keeps every node reachable right now alive until the guard is dropped.
+	[[nodiscard]] guard_type pin() const { return m_epoch.pin(); }
+
+	// Erased nodes waiting for readers to move on.
+	size_type retired_count() const noexcept { return m_epoch.pending(); }
+
+	allocator_type get_allocator() const noexcept { return m_alloc; }
+	key_compare key_comp() const { return m_comp; }
+
+	bool empty() const noexcept { return size() == 0; }
+	size_type size() const noexcept { return m_size.load(std::memory_order_relaxed); }
+
+	iterator begin() noexcept { return iterator(m_head->successor()); }
+	iterator end() noexcept { return iterator(nullptr); }
+	const_iterator begin() const noexcept { return const_iterator(m_head->successor()); }
+	const_iterator end() const noexcept { return const_iterator(nullptr); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+
+	// Not thread-safe, no other operation may run concurrently.
+	void clear() noexcept
+	{
+		if (!m_head)
+			return;
+
+		// Erased nodes are either still linked, with their owner count left
+		// at one, or already retired; never free one twice.
+		m_epoch.reclaim_all();
+
+		Node* cur = m_head->next[0].load(std::memory_order_relaxed);
+		while (cur)
+		{
+			Node* nxt = Node::unmarked(cur->next[0].load(std::memory_order_relaxed));
+			destroy_node(cur);
+			cur = nxt;
+		}
+
+		for (size_t i = 0; i < MaxLevel; ++i)
+			m_head->next[i].store(nullptr, std::memory_order_relaxed);
+
+		m_level.store(1, std::memory_order_relaxed);
+		m_size.store(0, std::memory_order_relaxed);
+	}
+
+	std::pair<iterator, bool> insert(const value_type& v) { return emplace_impl(v); }
+	std::pair<iterator, bool> insert(value_type&& v) { return emplace_impl(std::move(v)); }
+
+	// Returns whether key was present. Only the erase whose mark lands
+	// first reports true when several race on the same key.
+	bool erase(const Key& key) { return erase_impl(key); }
+
+	iterator find(const Key& key)
+	{
+		guard_type guard = pin();
+		Node* x = find_ge(key);
+		if (x && key_eq(m_comp, x->kv.first, key))
+			return iterator(x);
+
+		return end();
+	}
+	const_iterator find(const Key& key) const
+	{
+		guard_type guard = pin();
+		const Node* x = find_ge(key);
+		if (x && key_eq(m_comp, x->kv.first, key))
+			return const_iterator(x);
+
+		return end();
+	}
+
+	bool contains(const Key& key) const
+	{
+		return find(key) != end();
+	}
+
+	iterator lower_bound(const Key& key)
+	{
+		guard_type guard = pin();
+		return iterator(find_ge(key));
+	}
+	const_iterator lower_bound(const Key& key) const
+	{
+		guard_type guard = pin();
+		return const_iterator(find_ge(key));
+	}
+
+private:
+	void ini_head()
+	{
+		value_type dummy{ Key{}, Value{} };
+		m_head = create_node(std::move(dummy), (uint8_t)(MaxLevel));
+		m_level.store(1, std::memory_order_relaxed);
+		m_size.store(0, std::memory_order_relaxed);
+	}
+
+	// Readers walk straight through nodes that are being erased, the keys
+	// and the forward links of those stay valid while pinned.
+	Node* find_ge(const Key& key) const noexcept
+	{
+		Node* x = m_head;
+		for (int i = m_level.load(std::memory_order_relaxed) - 1; i >= 0; --i)
+		{
+			Node* nxt = Node::unmarked(x->next[i].load(std::memory_order_acquire));
+			while (nxt && key_less(m_comp, nxt->kv.first, key))
+			{
+				x = nxt;
+				nxt = Node::unmarked(x->next[i].load(std::memory_order_acquire));
+			}
+		}
+
+		Node* n = Node::unmarked(x->next[0].load(std::memory_order_acquire));
+		while (n && n->deleted())
+			n = Node::unmarked(n->next[0].load(std::memory_order_acquire));
+
+		return n;
+	}
+
+	// Fills prev/next with the splice `key` falls into on every level below
+	// `level`, unlinking marked nodes met on the way. Every next[i] is the
+	// first unmarked node not less than key. Must be called pinned.
+	void find_splice(const Key& key, int level, Node** prev, Node** next) const noexcept
+	{
+	retry:
+		Node* x = m_head;
+		for (int i = level - 1; i >= 0; --i)
+		{
+			Node* cur = Node::unmarked(x->next[i].load(std::memory_order_acquire));
+			while (cur)
+			{
+				Node* succ = cur->next[i].load(std::memory_order_acquire);
+				while (Node::is_marked(succ))
+				{
+					Node* expected = cur;
+					if (!x->next[i].compare_exchange_strong(expected, Node::unmarked(succ), std::memory_order_acq_rel, std::memory_order_acquire))
+						goto retry;
+
+					cur = Node::unmarked(succ);
+					if (!cur)
+						break;
+					succ = cur->next[i].load(std::memory_order_acquire);
+				}
+
+				if (!cur || !key_less(m_comp, cur->kv.first, key))
+					break;
+
+				x = cur;
+				cur = Node::unmarked(succ);
+			}
+
+			prev[i] = x;
+			next[i] = cur;
+		}
+	}
+
+	// One generator per thread, writers must not share random state. The
+	// xorshift policy seeds without a syscall, so a short lived writer thread
+	// costs nothing extra.
+	static uint8_t random_height()
+	{
+		static thread_local XorShiftHeight height;
+		return height.template height<MaxLevel, PNumerator, PDenominator>(nullptr);
+	}
+
+	template <class V>
+	std::pair<iterator, bool> emplace_impl(V&& v)
+	{
+		guard_type guard = pin();
+
+		std::array<Node*, MaxLevel> prev{};
+		std::array<Node*, MaxLevel> next{};
+
+		find_splice(v.first, MaxLevel, prev.data(), next.data());
+		if (next[0] && key_eq(m_comp, next[0]->kv.first, v.first))
+			return { iterator(next[0]), false };
+
+		const uint8_t h = random_height();
+		int level = m_level.load(std::memory_order_relaxed);
+		while (h > level)
+		{
+			if (m_level.compare_exchange_weak(level, h, std::memory_order_relaxed))
+				break;
+		}
+
+		Node* n = create_node(std::forward<V>(v), h);
+
+		// Level 0 publishes the node. Lost races redo the splice from the head,
+		// the old predecessor may be on its way out.
+		for (;;)
+		{
+			n->next[0].store(next[0], std::memory_order_relaxed);
+			Node* expected = next[0];
+			if (prev[0]->next[0].compare_exchange_strong(expected, n, std::memory_order_release, std::memory_order_relaxed))
+				break;
+
+			find_splice(n->kv.first, MaxLevel, prev.data(), next.data());
+			if (next[0] && key_eq(m_comp, next[0]->kv.first, n->kv.first))
+			{
+				destroy_node(n);
+				return { iterator(next[0]), false };
+			}
+		}
+
+		m_size.fetch_add(1, std::memory_order_relaxed);
+
+		// Upper levels. The node's own link is swung with a CAS so a mark
+		// from a concurrent erase is never overwritten; once marked we stop.
+		for (int i = 1; i < h; ++i)
+		{
+			for (;;)
+			{
+				Node* own = n->next[i].load(std::memory_order_acquire);
+				if (Node::is_marked(own) || !n->next[i].compare_exchange_strong(own, next[i], std::memory_order_release, std::memory_order_acquire))
+					goto linked;
+
+				Node* expected = next[i];
+				if (prev[i]->next[i].compare_exchange_strong(expected, n, std::memory_order_release, std::memory_order_relaxed))
+					break;
+
+				find_splice(n->kv.first, MaxLevel, prev.data(), next.data());
+				if (next[0] != n)
+					goto linked;	// erased in the meantime
+			}
+		}
+
+	linked:
+		// An erase that ran while the upper levels were going in may have
+		// missed the levels linked after its own cleanup. Store then load on
+		// both sides (our links then its mark, its mark then its cleanup
+		// walk): without a full fence on each side the load could be ordered
+		// before the store, both would miss the other and a level stay linked.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (n->deleted())
+			find_splice(n->kv.first, MaxLevel, prev.data(), next.data());
+
+		iterator it(n);
+		release_node(n);
+		return { it, true };
+	}
+
+	bool erase_impl(const Key& key)
+	{
+		guard_type guard = pin();
+
+		std::array<Node*, MaxLevel> prev{};
+		std::array<Node*, MaxLevel> next{};
+
+		find_splice(key, MaxLevel, prev.data(), next.data());
+		Node* victim = next[0];
+		if (!victim || !key_eq(m_comp, victim->kv.first, key))
+			return false;
+
+		for (int i = victim->height - 1; i >= 1; --i)
+		{
+			Node* succ = victim->next[i].load(std::memory_order_acquire);
+			while (!Node::is_marked(succ))
+			{
+				if (victim->next[i].compare_exchange_weak(succ, Node::marked(succ), std::memory_order_acq_rel, std::memory_order_acquire))
+					break;
+			}
+		}
+
+		Node* succ = victim->next[0].load(std::memory_order_acquire);
+		for (;;)
+		{
+			if (Node::is_marked(succ))
+				return false;	// another erase got there first
+
+			if (victim->next[0].compare_exchange_weak(succ, Node::marked(succ), std::memory_order_acq_rel, std::memory_order_acquire))
+				break;
+		}
+
+		m_size.fetch_sub(1, std::memory_order_relaxed);
+
+		// Pairs with the fence after the upper levels in emplace_impl.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		find_splice(key, MaxLevel, prev.data(), next.data());
+		release_node(victim);
+		return true;
+	}
+
+private:
+	Compare				m_comp{};
+	Alloc				m_alloc{};
+	byte_alloc			m_byte_alloc{};
+	Node*				m_head = nullptr;
+	std::atomic<int>	m_level{ 1 };
+	std::atomic<size_t>	m_size{ 0 };
+	mutable EpochDomain	m_epoch;
+};
@@ -0,0 +1,609 @@
+#pragma once
+
+#include <SimpleSTL/Memory/Arena.h>
+#include <SimpleSTL/Types/SkipListHeight.h>
+
+#include <cassert>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+
+template<class NodePtr, class ValueRef, class ValuePtr>
+class IndexableSkipListIterator
+{
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = std::remove_cv_t<std::remove_reference_t<ValueRef>>;
+	using difference_type = std::ptrdiff_t;
+	using pointer = ValuePtr;
+	using reference = ValueRef;
+
+	IndexableSkipListIterator() noexcept = default;
+	explicit IndexableSkipListIterator(NodePtr n) noexcept
+		:	m_node(n) { }
+
+	// iterator -> const_iterator
+	template<class N, class R, class P>
+		requires std::is_convertible_v<N, NodePtr>
+	IndexableSkipListIterator(const IndexableSkipListIterator<N, R, P>& other) noexcept
+		:	m_node(other.node()) { }
+
+	reference operator*() const noexcept { return m_node->kv; }
+	pointer operator->() const noexcept { return std::addressof(m_node->kv); }
+
+	IndexableSkipListIterator& operator++() noexcept
+	{
+		m_node = m_node->links[0].next;
+		return *this;
+	}
+	IndexableSkipListIterator operator++(int) noexcept
+	{
+		IndexableSkipListIterator tmp(*this);
+		++(*this);
+		return tmp;
+	}
+
+	// Moves n entries forward riding the widest link that does not overshoot,
+	// O(log n) expected. Past the last entry the iterator becomes end().
+	IndexableSkipListIterator& advance(size_t n) noexcept
+	{
+		while (n && m_node)
+		{
+			int i = (int)(m_node->height) - 1;
+			while (i > 0 && (!m_node->links[i].next || m_node->links[i].width > n))
+				--i;
+
+			n -= m_node->links[i].width < n ? m_node->links[i].width : n;
+			m_node = m_node->links[i].next;
+		}
+		return *this;
+	}
+
+	friend bool operator==(const IndexableSkipListIterator& a, const IndexableSkipListIterator& b) noexcept
+	{
+		return a.m_node == b.m_node;
+	}
+	friend bool operator!=(const IndexableSkipListIterator& a, const IndexableSkipListIterator& b) noexcept
+	{
+		return !(a == b);
+	}
+
+	NodePtr node() const noexcept { return m_node; }
+
+private:
+	NodePtr m_node = nullptr;
+};
+
+
+// SkipList that stores next to every link the number of level 0 steps it
+// spans. That gives rank(key), nth(i) and iterator advance(n) in O(log n).
+// A link to the end of the list spans up to a virtual position size() + 1.
+template<
+	class Key,
+	class Value,
+	class Compare = std::less<Key>,
+	class Alloc = std::allocator<std::pair<const Key, Value>>,
+	int MaxLevel = 12,
+	int PNumerator = 1,
+	int PDenominator = 4,
+	class HeightPolicy = XorShiftHeight
+>
+class IndexableSkipList
+{
+private:
+	static_assert(MaxLevel >= 2, "Max level must be more or equal than 2");
+	static_assert(PNumerator > 0 && PDenominator > 0 && PNumerator < PDenominator, "P must be 0 < P < 1");
+
+public:
+	using key_type = Key;
+	using mapped_type = Value;
+	using value_type = std::pair<const Key, Value>;
+	using size_type = size_t;
+	using diff_type = std::ptrdiff_t;
+	using key_compare = Compare;
+	using allocator_type = Alloc;
+
+private:
+	using byte_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::byte>;
+	using byte_traits = std::allocator_traits<byte_alloc>;
+
+	static constexpr bool arena_nodes = is_arena_allocator_v<byte_alloc>;
+
+	// Same rule as SkipList, clear() only rewinds an arena no other holder
+	// has nodes in.
+	bool owns_arena() const noexcept { return m_byte_alloc.arena().holders() == 1; }
+
+	struct Node;
+
+	struct Link
+	{
+		Node* next = nullptr;
+		size_t width = 1;
+	};
+
+	struct Node
+	{
+		value_type kv;
+		uint8_t height = 1;
+		Link links[1];
+
+		Node(const value_type& v, uint8_t h)
+			: kv(v), height(h) { }
+
+		Node(value_type&& v, uint8_t h)
+			: kv(std::move(v)), height(h) { }
+	};
+
+	static constexpr size_t node_bytes(uint8_t height) noexcept
+	{
+		return sizeof(Node) + (static_cast<size_t>(height) - 1) * sizeof(Link);
+	}
+
+	template<class T>
+	Node* create_node(T&& t, uint8_t height)
+	{
+		assert(height >= 1 && height <= MaxLevel);
+
+		const size_t bytes = node_bytes(height);
+		std::byte* memory = byte_traits::allocate(m_byte_alloc, bytes);
+
+		Node* n = nullptr;
+		try
+		{
+			n = ::new (static_cast<void*>(memory)) Node(std::forward<T>(t), height);
+			for (size_t i = 0; i < height; ++i)
+			{
+				n->links[i] = Link{};
+			}
+		}
+		catch (...)
+		{
+			byte_traits::deallocate(m_byte_alloc, memory, bytes);
+			throw;
+		}
+
+		return n;
+	}
+
+	void destroy_node(Node* n) noexcept
+	{
+		if (!n)
+			return;
+
+		const size_t bytes = node_bytes(n->height);
+		auto* memory = reinterpret_cast<std::byte*>(n);
+
+		n->~Node();
+		byte_traits::deallocate(m_byte_alloc, memory, bytes);
+	}
+
+	static constexpr bool key_less(const Compare& comp, const Key& a, const Key& b)
+	{
+		return comp(a, b);
+	}
+
+	static constexpr bool key_eq(const Compare& comp, const Key& a, const Key& b)
+	{
+		return !comp(a, b) && !comp(b, a);
+	}
+
+public:
+	using iterator = IndexableSkipListIterator<Node*, value_type&, value_type*>;
+	using const_iterator = IndexableSkipListIterator<const Node*, const value_type&, const value_type*>;
+
+	IndexableSkipList()
+		: IndexableSkipList(Compare{}, Alloc{}) { }
+
+	explicit IndexableSkipList(const Compare& comp, const Alloc& alloc = Alloc{})
+		: m_comp(comp), m_alloc(alloc), m_byte_alloc(alloc)
+	{
+		ini_head();
+	}
+
+	IndexableSkipList(const IndexableSkipList& other)
+		: m_comp(other.m_comp),
+		m_alloc(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.m_alloc)),
+		m_byte_alloc(m_alloc)
+	{
+		ini_head();
+		try
+		{
+			copy_nodes(other);
+		}
+		catch (...)
+		{
+			clear();
+			destroy_head();
+			throw;
+		}
+	}
+
+	IndexableSkipList& operator=(const IndexableSkipList& other)
+	{
+		if (this == &other)
+			return *this;
+
+		clear();
+		m_comp = other.m_comp;
+
+		if (!m_head)
+			ini_head();
+
+		try
+		{
+			copy_nodes(other);
+		}
+		catch (...)
+		{
+			clear();
+			throw;
+		}
+		return *this;
+	}
+
+	IndexableSkipList(IndexableSkipList&& other) noexcept
+		: m_comp(std::move(other.m_comp)),
+		m_alloc(std::move(other.m_alloc)),
+		m_byte_alloc(std::move(other.m_byte_alloc)),
+		m_head(other.m_head),
+		m_level(other.m_level),
+		m_size(other.m_size),
+		m_height(std::move(other.m_height))
+	{
+		other.m_head = nullptr;
+		other.m_level = 1;
+		other.m_size = 0;
+	}
+
+	IndexableSkipList& operator=(IndexableSkipList&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		clear();
+		destroy_head();
+
+		if constexpr (std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value)
+		{
+			m_alloc = std::move(other.m_alloc);
+			m_byte_alloc = std::move(other.m_byte_alloc);
+		}
+
+		m_comp = std::move(other.m_comp);
+		m_head = other.m_head;
+		m_level = other.m_level;
+		m_size = other.m_size;
+		m_height = std::move(other.m_height);
+
+		other.m_head = nullptr;
+		other.m_level = 1;
+		other.m_size = 0;
+		return *this;
+	}
+
+	~IndexableSkipList()
+	{
+		clear();
+		destroy_head();
+	}
+
+	allocator_type get_allocator() const noexcept { return m_alloc; }
+	key_compare key_comp() const { return m_comp; }
+
+	bool empty() const noexcept { return m_size == 0; }
+	size_type size() const noexcept { return m_size; }
+
+	iterator begin() noexcept { return iterator(m_head->links[0].next); }
+	iterator end() noexcept { return iterator(nullptr); }
+	const_iterator begin() const noexcept { return const_iterator(m_head->links[0].next); }
+	const_iterator end() const noexcept { return const_iterator(nullptr); }
+	const_iterator cbegin() const noexcept { return const_iterator(m_head->links[0].next); }
+	const_iterator cend() const noexcept { return const_iterator(nullptr); }
+
+	void clear() noexcept
+	{
+		if (!m_head)
+			return;
+
+		if constexpr (arena_nodes)
+		{
+			if constexpr (!std::is_trivially_destructible_v<value_type>)
+			{
+				Node* cur = m_head->links[0].next;
+				while (cur)
+				{
+					Node* nxt = cur->links[0].next;
+					cur->~Node();
+					cur = nxt;
+				}
+			}
+
+			if (owns_arena())
+				m_byte_alloc.arena().reset();
+		}
+		else
+		{
+			Node* cur = m_head->links[0].next;
+			while (cur)
+			{
+				Node* nxt = cur->links[0].next;
+				destroy_node(cur);
+				cur = nxt;
+			}
+		}
+
+		for (size_t i = 0; i < MaxLevel; ++i)
+			m_head->links[i] = Link{};
+
+		m_level = 1;
+		m_size = 0;
+	}
+
+	std::pair<iterator, bool> insert(const value_type& v) { return emplace_impl(v); }
+	std::pair<iterator, bool> insert(value_type&& v) { return emplace_impl(std::move(v)); }
+
+	std::pair<iterator, bool> erase(const key_type& v) { return erase_impl(v); }
+
+	iterator find(const Key& key) noexcept
+	{
+		Node* x = find_ge(key);
+		if (x && key_eq(m_comp, x->kv.first, key))
+			return iterator(x);
+
+		return end();
+	}
+	const_iterator find(const Key& key) const noexcept
+	{
+		return const_cast<IndexableSkipList*>(this)->find(key);
+	}
+
+	bool contains(const Key& key) const noexcept
+	{
+		return find(key) != end();
+	}
+
+	iterator lower_bound(const Key& key) noexcept
+	{
+		return iterator(find_ge(key));
+	}
+	const_iterator lower_bound(const Key& key) const noexcept
+	{
+		return const_cast<IndexableSkipList*>(this)->lower_bound(key);
+	}
+
+	// Number of entries with a key less than `key`, which is also the index
+	// of `key` when present.
+	size_type rank(const Key& key) const noexcept
+	{
+		const Node* x = m_head;
+		size_type pos = 0;
+		for (int i = (int)(m_level) - 1; i >= 0; --i)
+		{
+			while (x->links[i].next && key_less(m_comp, x->links[i].next->kv.first, key))
+			{
+				pos += x->links[i].width;
+				x = x->links[i].next;
+			}
+		}
+
+		return pos;
+	}
+
+	// Entry at the 0-based `index`, end() when out of range.
+	iterator nth(size_type index) noexcept
+	{
+		if (index >= m_size)
+			return end();
+
+		const size_type target = index + 1;
+		Node* x = m_head;
+		size_type pos = 0;
+		for (int i = (int)(m_level) - 1; i >= 0; --i)
+		{
+			while (x->links[i].next && pos + x->links[i].width <= target)
+			{
+				pos += x->links[i].width;
+				x = x->links[i].next;
+			}
+		}
+
+		assert(pos == target);
+		return iterator(x);
+	}
+	const_iterator nth(size_type index) const noexcept
+	{
+		return const_cast<IndexableSkipList*>(this)->nth(index);
+	}
+
+private:
+	void ini_head()
+	{
+		value_type dummy{ Key{}, Value{} };
+		m_head = create_node(std::move(dummy), (uint8_t)(MaxLevel));
+		if constexpr (arena_nodes)
+		{
+			m_byte_alloc.arena().pin();
+			m_byte_alloc.arena().attach();
+		}
+
+		m_level = 1;
+		m_size = 0;
+	}
+
+	void destroy_head() noexcept
+	{
+		if (!m_head)
+			return;
+
+		destroy_node(m_head);
+		m_head = nullptr;
+		if constexpr (arena_nodes)
+			m_byte_alloc.arena().detach();
+	}
+
+	Node* find_ge(const Key& key) noexcept
+	{
+		Node* x = m_head;
+		for (int i = (int)(m_level) - 1; i >= 0; --i)
+		{
+			while (x->links[i].next && key_less(m_comp, x->links[i].next->kv.first, key))
+				x = x->links[i].next;
+		}
+
+		return x->links[0].next;
+	}
+
+	// Appends copies of other's nodes with their heights unchanged, linked in
+	// one pass through a per-level tail array. Same towers means the same
+	// spans, so the widths are copied as they are. The list must be empty.
+	void copy_nodes(const IndexableSkipList& other)
+	{
+		assert(m_size == 0);
+		if (!other.m_head)
+			return;
+
+		if constexpr (arena_nodes)
+		{
+			constexpr size_t align = alignof(std::max_align_t);
+
+			size_t bytes = 0;
+			for (const Node* x = other.m_head->links[0].next; x; x = x->links[0].next)
+				bytes += (node_bytes(x->height) + align - 1) & ~(align - 1);
+			m_byte_alloc.arena().reserve(bytes);
+		}
+
+		std::array<Node*, MaxLevel> tails{};
+		tails.fill(m_head);
+
+		for (size_t i = 0; i < MaxLevel; ++i)
+			m_head->links[i].width = other.m_head->links[i].width;
+
+		for (const Node* x = other.m_head->links[0].next; x; x = x->links[0].next)
+		{
+			Node* n = create_node(x->kv, x->height);
+			for (size_t i = 0; i < n->height; ++i)
+			{
+				tails[i]->links[i].next = n;
+				n->links[i].width = x->links[i].width;
+				tails[i] = n;
+			}
+
+			if (n->height > m_level)
+				m_level = n->height;
+
+			++m_size;
+		}
+	}
+
+	uint8_t random_height(const Key& key)
+	{
+		return m_height.template height<MaxLevel, PNumerator, PDenominator>(key);
+	}
+
+	template <class V>
+	std::pair<iterator, bool> emplace_impl(V&& v)
+	{
+		std::array<Node*, MaxLevel> update{};
+		std::array<size_t, MaxLevel> rank{};
+		update.fill(m_head);
+
+		Node* x = m_head;
+		size_t pos = 0;
+		for (int i = (int)(m_level) - 1; i >= 0; --i)
+		{
+			while (x->links[i].next && key_less(m_comp, x->links[i].next->kv.first, v.first))
+			{
+				pos += x->links[i].width;
+				x = x->links[i].next;
+			}
+
+			update[i] = x;
+			rank[i] = pos;
+		}
+
+		x = x->links[0].next;
+		if (x && key_eq(m_comp, x->kv.first, v.first))
+			return { iterator(x), false };
+
+		uint8_t h = random_height(v.first);
+		if (h > m_level)
+			m_level = h;
+
+		Node* n = create_node(std::forward<V>(v), h);
+		const size_t n_pos = rank[0] + 1;
+
+		for (size_t i = 0; i < h; ++i)
+		{
+			Link& prev = update[i]->links[i];
+
+			n->links[i].next = prev.next;
+			n->links[i].width = rank[i] + prev.width + 1 - n_pos;
+
+			prev.next = n;
+			prev.width = n_pos - rank[i];
+		}
+
+		// links jumping over the new node, including the unused head levels
+		// that span to the end
+		for (size_t i = h; i < MaxLevel; ++i)
+			++update[i]->links[i].width;
+
+		++m_size;
+		return { iterator(n), true };
+	}
+
+	template <class V>
+	std::pair<iterator, bool> erase_impl(V&& v)
+	{
+		std::array<Node*, MaxLevel> update{};
+		update.fill(m_head);
+
+		Node* x = m_head;
+		for (int i = (int)(m_level) - 1; i >= 0; --i)
+		{
+			while (x->links[i].next && key_less(m_comp, x->links[i].next->kv.first, v))
+				x = x->links[i].next;
+
+			update[i] = x;
+		}
+
+		x = x->links[0].next;
+		if (!x || !key_eq(m_comp, x->kv.first, v))
+			return { iterator(x), false };
+
+		for (size_t i = 0; i < x->height; ++i)
+		{
+			Link& prev = update[i]->links[i];
+
+			prev.width += x->links[i].width - 1;
+			prev.next = x->links[i].next;
+		}
+
+		for (size_t i = x->height; i < MaxLevel; ++i)
+			--update[i]->links[i].width;
+
+		Node* next = x->links[0].next;
+		destroy_node(x);
+		--m_size;
+
+		while (m_level > 1 && m_head->links[m_level - 1].next == nullptr)
+			--m_level;
+
+		return { iterator(next), true };
+	}
+
+private:
+	Compare		m_comp{};
+	Alloc		m_alloc{};
+	byte_alloc	m_byte_alloc{};
+	Node*		m_head = nullptr;
+	uint8_t		m_level = 1;
+	size_t		m_size = 0;
+	[[no_unique_address]] HeightPolicy m_height{};
+};
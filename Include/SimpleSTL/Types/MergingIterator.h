@@ -0,0 +1,249 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// Merges N sorted sources (SkipList, UnrolledSkipList, ByteSkipList, ... any
+// container with const_iterator, lower_bound and pair-like elements) into one
+// ordered stream. Sources are given newest first: when several hold the same
+// key only the entry of the lowest-index source is yielded, the older ones are
+// skipped.
+//
+// The current head of every source sits in a loser tree, so advancing and
+// seeking replay a single leaf-to-root path: O(log N) comparisons per step
+// instead of the O(N) of a linear min scan. Sources must stay unmodified for
+// as long as the iterator is used. Keys are read from the source iterators on
+// every comparison and an iterator is only advanced once its key is no longer
+// needed, so keys that live in the iterator itself (SortedTable) are fine.
+template<class Source, class Compare = typename Source::key_compare>
+class MergingIterator
+{
+public:
+	using source_type = Source;
+	using source_iterator = typename Source::const_iterator;
+	using key_type = typename Source::key_type;
+	using key_compare = Compare;
+	using reference = typename std::iterator_traits<source_iterator>::reference;
+
+private:
+	// Sources whose iterators hand out pairs by value (ByteSkipList) get their
+	// keys and values copied out, those are views into the node anyway.
+	using value_pair = std::remove_cvref_t<reference>;
+	using key_reference = std::conditional_t<std::is_reference_v<reference>, const typename value_pair::first_type&, typename value_pair::first_type>;
+	using value_reference = std::conditional_t<std::is_reference_v<reference>, const typename value_pair::second_type&, typename value_pair::second_type>;
+
+public:
+	MergingIterator(std::initializer_list<const Source*> sources, const Compare& comp = Compare{})
+		: MergingIterator(std::vector<const Source*>(sources), comp) { }
+
+	explicit MergingIterator(const std::vector<const Source*>& sources, const Compare& comp = Compare{})
+		: m_comp(comp), m_k(sources.size()), m_tree(sources.size() ? sources.size() : 1, 0), m_winner(2 * sources.size())
+	{
+		m_heads.reserve(m_k);
+		for (const Source* s : sources)
+			m_heads.push_back({ s, s->end(), s->end() });
+
+		seek_to_first();
+	}
+
+	size_t source_count() const noexcept { return m_k; }
+
+	bool valid() const noexcept { return m_k != 0 && !exhausted(m_tree[0]); }
+
+	// Index of the source the current entry comes from.
+	size_t source() const noexcept { return m_tree[0]; }
+
+	source_iterator current() const noexcept { return m_heads[m_tree[0]].it; }
+
+	reference operator*() const { return *m_heads[m_tree[0]].it; }
+	auto operator->() const { return m_heads[m_tree[0]].it.operator->(); }
+
+	key_reference key() const { return key_of(m_tree[0]); }
+	value_reference value() const { return (*m_heads[m_tree[0]].it).second; }
+
+	void seek_to_first()
+	{
+		for (Head& h : m_heads)
+		{
+			h.it = h.source->begin();
+			h.end = h.source->end();
+		}
+
+		build();
+	}
+
+	// Positions on the first key not less than key across all sources.
+	template<class K>
+	void seek(const K& key)
+	{
+		for (Head& h : m_heads)
+		{
+			h.it = h.source->lower_bound(key);
+			h.end = h.source->end();
+		}
+
+		build();
+	}
+
+	template<class K>
+	void lower_bound(const K& key)
+	{
+		seek(key);
+	}
+
+	// Moves past the current key, dropping older duplicates of it. The
+	// duplicates go first, the winner keeps the top (it is the newest of them)
+	// and its key stays valid to compare against until it moves last.
+	void next()
+	{
+		assert(valid());
+
+		const size_t top = m_tree[0];
+		for (size_t dup = runner_up(); dup != m_k && !exhausted(dup) && !m_comp(key_of(top), key_of(dup)); dup = runner_up())
+		{
+			++m_heads[dup].it;
+			replay_loser(dup);
+		}
+
+		++m_heads[top].it;
+		replay(top);
+	}
+
+	MergingIterator& operator++()
+	{
+		next();
+		return *this;
+	}
+
+	friend bool operator==(const MergingIterator& it, std::default_sentinel_t) noexcept
+	{
+		return !it.valid();
+	}
+
+	// Range-for support: for (auto&& kv : merging_iterator) walks a copy from
+	// the current position to the end.
+	MergingIterator begin() const { return *this; }
+	std::default_sentinel_t end() const noexcept { return std::default_sentinel; }
+
+private:
+	struct Head
+	{
+		const Source*	source;
+		source_iterator	it;
+		source_iterator	end;
+	};
+
+	key_reference key_of(size_t i) const { return (*m_heads[i].it).first; }
+
+	bool exhausted(size_t i) const noexcept { return m_heads[i].it == m_heads[i].end; }
+
+	// Does leaf a come out before leaf b. Exhausted sources lose to everything,
+	// equal keys go to the newer (lower index) source.
+	bool beats(size_t a, size_t b) const
+	{
+		if (exhausted(a))
+			return false;
+		if (exhausted(b))
+			return true;
+
+		if (m_comp(key_of(a), key_of(b)))
+			return true;
+		if (m_comp(key_of(b), key_of(a)))
+			return false;
+
+		return a < b;
+	}
+
+	// Leaves are the heap slots [k, 2k), internal slot n (1 <= n < k) keeps
+	// the loser of the match between its children and m_tree[0] the overall
+	// winner. Built bottom-up through a scratch array of match winners.
+	void build()
+	{
+		if (m_k <= 1)
+		{
+			m_tree[0] = 0;
+			return;
+		}
+
+		std::vector<size_t>& winner = m_winner;
+		for (size_t i = 0; i < m_k; ++i)
+			winner[m_k + i] = i;
+
+		for (size_t n = m_k - 1; n >= 1; --n)
+		{
+			const size_t l = winner[2 * n];
+			const size_t r = winner[2 * n + 1];
+			if (beats(r, l))
+			{
+				winner[n] = r;
+				m_tree[n] = l;
+			}
+			else
+			{
+				winner[n] = l;
+				m_tree[n] = r;
+			}
+		}
+
+		m_tree[0] = winner[1];
+	}
+
+	// Best source after the winner, m_k if there is none. It can only have
+	// lost to the winner, so it is one of the losers on the winner's path.
+	size_t runner_up() const
+	{
+		size_t best = m_k;
+		for (size_t n = (m_k + m_tree[0]) / 2; n >= 1; n /= 2)
+		{
+			if (best == m_k || beats(m_tree[n], best))
+				best = m_tree[n];
+		}
+
+		return best;
+	}
+
+	// Leaf i changed, replay its matches up to the root.
+	void replay(size_t i)
+	{
+		size_t win = i;
+		for (size_t n = (m_k + i) / 2; n >= 1; n /= 2)
+		{
+			if (beats(m_tree[n], win))
+				std::swap(m_tree[n], win);
+		}
+
+		m_tree[0] = win;
+	}
+
+	// Leaf i, stored as a loser somewhere on its path, changed while the
+	// winner did not: replay its matches up to that node, which takes the
+	// new subtree winner, the matches above it stay as they are.
+	void replay_loser(size_t i)
+	{
+		size_t win = i;
+		for (size_t n = (m_k + i) / 2; n >= 1; n /= 2)
+		{
+			if (m_tree[n] == i)
+			{
+				m_tree[n] = win;
+				return;
+			}
+
+			if (beats(m_tree[n], win))
+				std::swap(m_tree[n], win);
+		}
+	}
+
+private:
+	Compare				m_comp;
+	size_t				m_k;
+	std::vector<Head>	m_heads;
+	std::vector<size_t>	m_tree;
+	std::vector<size_t>	m_winner;
+};
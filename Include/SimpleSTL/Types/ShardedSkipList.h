@@ -0,0 +1,426 @@
+#pragma once
+
+#include <SimpleSTL/Types/SkipList.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+// Test and test-and-set lock. Critical sections of ShardedSkipList are a
+// single skip list operation, short enough that spinning (and yielding when
+// the holder got descheduled) beats parking the thread.
+class SpinLock
+{
+public:
+	void lock() noexcept
+	{
+		for (int spins = 0; m_locked.exchange(true, std::memory_order_acquire); )
+		{
+			while (m_locked.load(std::memory_order_relaxed))
+			{
+				if (++spins > 64)
+					std::this_thread::yield();
+			}
+		}
+	}
+
+	bool try_lock() noexcept
+	{
+		return !m_locked.load(std::memory_order_relaxed) && !m_locked.exchange(true, std::memory_order_acquire);
+	}
+
+	void unlock() noexcept
+	{
+		m_locked.store(false, std::memory_order_release);
+	}
+
+private:
+	std::atomic<bool> m_locked{ false };
+};
+
+
+// SkipList split by key range into a fixed number of shards, each behind its
+// own lock. Shard i holds the keys in [bounds[i-1], bounds[i]), point
+// operations lock exactly one shard and scans walk the shards in key order,
+// holding one lock at a time.
+//
+// The bounds live in an immutable layout published through an atomic
+// pointer, so routing is one load and a binary search. rebalance() swaps in a
+// new layout while holding every shard lock; an operation that routed with
+// the old one notices after locking and routes again. Retired layouts are
+// kept so a stale pointer never dangles, each rebalance() leaves one behind
+// (shard_count() - 1 keys). Nothing reclaims them concurrently, call
+// reclaim_layouts() at a point where no other thread is using the list.
+//
+// Nothing hands out iterators or references past its own lock: lookups copy
+// the value out or run a callback on the locked entry.
+template<
+	class Key,
+	class Value,
+	class Compare = std::less<Key>,
+	class Alloc = std::allocator<std::pair<const Key, Value>>,
+	int MaxLevel = 12,
+	int PNumerator = 1,
+	int PDenominator = 4
+>
+class ShardedSkipList
+{
+public:
+	using list_type = SkipList<Key, Value, Compare, Alloc, MaxLevel, PNumerator, PDenominator>;
+	using key_type = Key;
+	using mapped_type = Value;
+	using value_type = std::pair<const Key, Value>;
+	using size_type = size_t;
+	using key_compare = Compare;
+	using allocator_type = Alloc;
+
+	// Starts with every bound at Key{}: keys less than Key{} go to the first
+	// shard and all others to the last. Call rebalance() once there is data
+	// or pass bounds up front.
+	explicit ShardedSkipList(size_t shards = 16, const Compare& comp = Compare{}, const Alloc& alloc = Alloc{})
+		: ShardedSkipList(std::vector<Key>(shards > 1 ? shards - 1 : 0, Key{}), comp, alloc) { }
+
+	// bounds must be sorted, there will be bounds.size() + 1 shards.
+	explicit ShardedSkipList(std::vector<Key> bounds, const Compare& comp = Compare{}, const Alloc& alloc = Alloc{})
+		: m_comp(comp), m_count(bounds.size() + 1), m_shards(std::make_unique<Shard[]>(bounds.size() + 1))
+	{
+		assert(std::is_sorted(bounds.begin(), bounds.end(), m_comp) && "shard bounds must be sorted");
+
+		for (size_t i = 0; i < m_count; ++i)
+			m_shards[i].list = list_type(comp, alloc);
+
+		publish(std::make_unique<Layout>(Layout{ std::move(bounds) }));
+	}
+
+	ShardedSkipList(const ShardedSkipList&) = delete;
+	ShardedSkipList& operator=(const ShardedSkipList&) = delete;
+
+	key_compare key_comp() const { return m_comp; }
+	size_t shard_count() const noexcept { return m_count; }
+
+	// Sums the shards one lock at a time, exact only while no one writes.
+	size_type size() const
+	{
+		size_type total = 0;
+		for (size_t i = 0; i < m_count; ++i)
+		{
+			std::lock_guard<SpinLock> lock(m_shards[i].lock);
+			total += m_shards[i].list.size();
+		}
+		return total;
+	}
+
+	bool empty() const { return size() == 0; }
+
+	std::vector<size_type> shard_sizes() const
+	{
+		std::vector<size_type> sizes(m_count);
+		for (size_t i = 0; i < m_count; ++i)
+		{
+			std::lock_guard<SpinLock> lock(m_shards[i].lock);
+			sizes[i] = m_shards[i].list.size();
+		}
+		return sizes;
+	}
+
+	std::vector<Key> bounds() const
+	{
+		return m_layout.load(std::memory_order_acquire)->bounds;
+	}
+
+	bool insert(const value_type& v)
+	{
+		return with_shard(v.first, [&](list_type& list) { return list.insert(v).second; });
+	}
+	bool insert(value_type&& v)
+	{
+		const Key& key = v.first;
+		return with_shard(key, [&](list_type& list) { return list.insert(std::move(v)).second; });
+	}
+
+	template<class M>
+	bool insert_or_assign(const Key& key, M&& value)
+	{
+		return with_shard(key, [&](list_type& list) { return list.insert_or_assign(key, std::forward<M>(value)).second; });
+	}
+
+	bool insert_or_assign(const Key& key, const Value& value) { return insert_or_assign<const Value&>(key, value); }
+	bool insert_or_assign(const Key& key, Value&& value) { return insert_or_assign<Value>(key, std::move(value)); }
+
+	bool erase(const Key& key)
+	{
+		return with_shard(key, [&](list_type& list) { return list.erase(key).second; });
+	}
+
+	bool contains(const Key& key) const
+	{
+		return with_shard(key, [&](const list_type& list) { return list.contains(key); });
+	}
+
+	// Copies the value out, returns false when key is missing.
+	bool get(const Key& key, Value& out) const
+	{
+		return with_shard(key, [&](const list_type& list)
+			{
+				auto it = list.find(key);
+				if (it == list.end())
+					return false;
+
+				out = it->second;
+				return true;
+			});
+	}
+
+	// Runs f(value_type&) on the entry under its shard lock, returns false
+	// when key is missing.
+	template<class F>
+	bool visit(const Key& key, F&& f)
+	{
+		return with_shard(key, [&](list_type& list)
+			{
+				auto it = list.find(key);
+				if (it == list.end())
+					return false;
+
+				f(*it);
+				return true;
+			});
+	}
+
+	// Calls f(const value_type&) for every key not less than from, in order,
+	// until f returns false. Each shard is locked while it is walked, so the
+	// scan sees every shard at some point in time, not the whole list at once.
+	template<class F>
+	void scan(const Key& from, F&& f) const
+	{
+		scan_impl(&from, f);
+	}
+
+	template<class F>
+	void for_each(F&& f) const
+	{
+		scan_impl(nullptr, f);
+	}
+
+	// Moves the bounds to the quantiles of the current contents so every
+	// shard ends up with about the same number of keys. Blocks all shards
+	// for the duration, O(n).
+	void rebalance()
+	{
+		AllLocked locked(*this);
+
+		const std::vector<const value_type*> items = collect_locked();
+
+		std::vector<Key> bounds;
+		bounds.reserve(m_count - 1);
+		for (size_t i = 1; i < m_count; ++i)
+			bounds.push_back(items.empty() ? Key{} : items[items.size() * i / m_count]->first);
+
+		redistribute(items, std::move(bounds));
+	}
+
+	// Same with caller chosen bounds, bounds.size() must be shard_count() - 1.
+	void rebalance(std::vector<Key> bounds)
+	{
+		assert(bounds.size() + 1 == m_count && "rebalance cannot change the shard count");
+		assert(std::is_sorted(bounds.begin(), bounds.end(), m_comp) && "shard bounds must be sorted");
+
+		AllLocked locked(*this);
+		redistribute(collect_locked(), std::move(bounds));
+	}
+
+	// Frees every layout but the current one. Not thread safe: no other
+	// thread may be inside any member of this list.
+	void reclaim_layouts()
+	{
+		const Layout* current = m_layout.load(std::memory_order_relaxed);
+		std::erase_if(m_layouts, [&](const std::unique_ptr<Layout>& layout) { return layout.get() != current; });
+	}
+
+	void clear()
+	{
+		for (size_t i = 0; i < m_count; ++i)
+		{
+			std::lock_guard<SpinLock> lock(m_shards[i].lock);
+			m_shards[i].list.clear();
+		}
+	}
+
+private:
+	struct Layout
+	{
+		std::vector<Key> bounds;
+	};
+
+	struct alignas(64) Shard
+	{
+		mutable SpinLock	lock;
+		list_type			list;
+	};
+
+	// Holds every shard lock for a scope, so a throwing rebuild still
+	// releases them.
+	struct AllLocked
+	{
+		explicit AllLocked(const ShardedSkipList& owner) : owner(owner) { owner.lock_all(); }
+		~AllLocked() { owner.unlock_all(); }
+
+		AllLocked(const AllLocked&) = delete;
+		AllLocked& operator=(const AllLocked&) = delete;
+
+		const ShardedSkipList& owner;
+	};
+
+	size_t route(const Layout& layout, const Key& key) const
+	{
+		return (size_t)(std::upper_bound(layout.bounds.begin(), layout.bounds.end(), key, m_comp) - layout.bounds.begin());
+	}
+
+	// Locks the shard owning key and runs op on its list. Retries when a
+	// rebalance slipped in between routing and locking.
+	template<class Op>
+	decltype(auto) with_shard(const Key& key, Op&& op) const
+	{
+		for (;;)
+		{
+			const Layout* layout = m_layout.load(std::memory_order_acquire);
+			Shard& shard = m_shards[route(*layout, key)];
+
+			std::lock_guard<SpinLock> lock(shard.lock);
+			if (m_layout.load(std::memory_order_relaxed) == layout)
+				return op(const_cast<const list_type&>(shard.list));
+		}
+	}
+
+	template<class Op>
+	decltype(auto) with_shard(const Key& key, Op&& op)
+	{
+		for (;;)
+		{
+			const Layout* layout = m_layout.load(std::memory_order_acquire);
+			Shard& shard = m_shards[route(*layout, key)];
+
+			std::lock_guard<SpinLock> lock(shard.lock);
+			if (m_layout.load(std::memory_order_relaxed) == layout)
+				return op(shard.list);
+		}
+	}
+
+	// After shard i is done the scan resumes at bounds[i] under whatever
+	// layout is current then, so a rebalance in between neither skips nor
+	// repeats keys.
+	template<class F>
+	void scan_impl(const Key* from, F& f) const
+	{
+		for (;;)
+		{
+			const Layout* layout = m_layout.load(std::memory_order_acquire);
+			const size_t i = from ? route(*layout, *from) : 0;
+			const Shard& shard = m_shards[i];
+
+			{
+				std::lock_guard<SpinLock> lock(shard.lock);
+				if (m_layout.load(std::memory_order_relaxed) != layout)
+					continue;
+
+				for (auto it = from ? shard.list.lower_bound(*from) : shard.list.begin(); it != shard.list.end(); ++it)
+				{
+					if (!f(*it))
+						return;
+				}
+			}
+
+			if (i + 1 == m_count)
+				return;
+
+			from = &layout->bounds[i];
+		}
+	}
+
+	void lock_all() const
+	{
+		for (size_t i = 0; i < m_count; ++i)
+			m_shards[i].lock.lock();
+	}
+
+	void unlock_all() const
+	{
+		for (size_t i = m_count; i-- > 0; )
+			m_shards[i].lock.unlock();
+	}
+
+	// Every entry in key order, all locks held. The shards hold disjoint,
+	// ascending key ranges, so walking them in turn is already sorted.
+	std::vector<const value_type*> collect_locked() const
+	{
+		size_t total = 0;
+		for (size_t i = 0; i < m_count; ++i)
+			total += m_shards[i].list.size();
+
+		std::vector<const value_type*> items;
+		items.reserve(total);
+		for (size_t i = 0; i < m_count; ++i)
+		{
+			for (const value_type& kv : m_shards[i].list)
+				items.push_back(&kv);
+		}
+		return items;
+	}
+
+	// Builds every shard's new list from the sorted items, all locks held.
+	// The lists are built aside and only moved into the shards once all of
+	// them exist, so a throwing copy leaves every shard as it was.
+	void redistribute(const std::vector<const value_type*>& items, std::vector<Key> bounds)
+	{
+		// allocate the new layout first, publishing must not throw once the
+		// shards are replaced
+		auto layout = std::make_unique<Layout>(Layout{ std::move(bounds) });
+		m_layouts.reserve(m_layouts.size() + 1);
+
+		std::vector<list_type> lists;
+		lists.reserve(m_count);
+
+		auto first = items.begin();
+		for (size_t i = 0; i < m_count; ++i)
+		{
+			auto last = i + 1 < m_count
+				? std::lower_bound(first, items.end(), layout->bounds[i], [&](const value_type* kv, const Key& b) { return m_comp(kv->first, b); })
+				: items.end();
+
+			auto values = std::ranges::subrange(first, last)
+				| std::views::transform([](const value_type* kv) -> const value_type& { return *kv; });
+
+			list_type& list = lists.emplace_back(m_comp,
+				std::allocator_traits<Alloc>::select_on_container_copy_construction(m_shards[i].list.get_allocator()));
+			list.assign_sorted(values.begin(), values.end());
+			first = last;
+		}
+
+		for (size_t i = 0; i < m_count; ++i)
+			m_shards[i].list = std::move(lists[i]);
+
+		publish(std::move(layout));
+	}
+
+	void publish(std::unique_ptr<Layout> layout)
+	{
+		m_layouts.push_back(std::move(layout));
+		m_layout.store(m_layouts.back().get(), std::memory_order_release);
+	}
+
+private:
+	Compare								m_comp{};
+	size_t								m_count;
+	std::unique_ptr<Shard[]>			m_shards;
+	std::atomic<const Layout*>			m_layout{ nullptr };
+	std::vector<std::unique_ptr<Layout>>	m_layouts;
+};
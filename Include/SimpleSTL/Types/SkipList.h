@@ -1,16 +1,34 @@
 #pragma once
 
+#include <SimpleSTL/Memory/Arena.h>
+#include <SimpleSTL/Types/SkipListCounters.h>
+#include <SimpleSTL/Types/SkipListHeight.h>
+
 #include <cassert>
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <exception>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
 
 
 template<class NodePtr, class ValueRef, class ValuePtr>
@@ -18,9 +36,11 @@ class SkipListIterator
 {
 public:
 	using iterator_category = std::forward_iterator_tag;
+	using value_type = std::remove_cv_t<std::remove_reference_t<ValueRef>>;
 	using vaule_type = std::remove_reference_t<ValueRef>;
 	using difference_type = std::ptrdiff_t;
 	using pointer = ValuePtr;
+	using reference = ValueRef;
 	using referance = ValueRef;
 
 	SkipListIterator() noexcept = default;
@@ -58,6 +78,99 @@ private:
 };
 
 
+template<class Iterator>
+class SkipListRange
+{
+public:
+	SkipListRange() noexcept = default;
+	SkipListRange(Iterator first, Iterator last) noexcept
+		:	m_first(first), m_last(last) { }
+
+	Iterator begin() const noexcept { return m_first; }
+	Iterator end() const noexcept { return m_last; }
+	bool empty() const noexcept { return m_first == m_last; }
+
+private:
+	Iterator m_first{};
+	Iterator m_last{};
+};
+
+
+// Order preserving prefix of a key that nodes cache next to their links. When
+// two prefixes differ they decide the comparison on their own, only ties fall
+// back to Compare. Disabled (an empty tag) unless Compare orders keys bytewise.
+template<class Key, class Compare>
+struct SkipListKeyPrefix
+{
+	static constexpr bool enabled = false;
+
+	struct type
+	{
+		friend bool operator==(type, type) noexcept { return true; }
+		friend bool operator<(type, type) noexcept { return false; }
+	};
+
+	static type make(const Key&) noexcept { return {}; }
+};
+
+template<class Key, class Compare>
+	requires ((std::is_same_v<Key, std::string> || std::is_same_v<Key, std::string_view>)
+		&& (std::is_same_v<Compare, std::less<Key>> || std::is_same_v<Compare, std::less<>>))
+struct SkipListKeyPrefix<Key, Compare>
+{
+	static constexpr bool enabled = true;
+
+	// First 8 bytes packed big-endian and zero padded, so unsigned integer
+	// order matches the bytewise (unsigned char) order of std::string.
+	using type = uint64_t;
+
+	static type make(std::string_view s) noexcept
+	{
+		if (s.size() >= sizeof(type))
+		{
+			type v;
+			std::memcpy(&v, s.data(), sizeof(type));
+			if constexpr (std::endian::native == std::endian::little)
+				v = byteswap(v);
+			return v;
+		}
+
+		type v = 0;
+		for (size_t i = 0; i < s.size(); ++i)
+			v |= static_cast<type>(static_cast<unsigned char>(s[i])) << (56 - 8 * i);
+		return v;
+	}
+
+private:
+	static type byteswap(type v) noexcept
+	{
+#if defined(_MSC_VER)
+		return _byteswap_uint64(v);
+#else
+		return __builtin_bswap64(v);
+#endif
+	}
+};
+
+
+// Snapshot returned by SkipList::stats().
+template<int MaxLevel>
+struct SkipListStats
+{
+	size_t							size = 0;
+	// Bytes held by the nodes and the head tower. Memory owned by the keys
+	// and values themselves (string buffers etc.) is not included.
+	size_t							node_bytes = 0;
+	uint8_t							level = 0;
+	uint8_t							max_height = 0;
+	double							average_height = 0.0;
+	// Estimated nodes compared by a lookup of a random key.
+	double							expected_search_path = 0.0;
+	// nodes_per_height[h - 1] counts the towers of height h.
+	std::array<size_t, MaxLevel>	nodes_per_height{};
+};
+
+
 template<
 	class Key,
 	class Value,
@@ -65,13 +178,16 @@ template<
 	class Alloc = std::allocator<std::pair<const Key, Value>>,
 	int MaxLevel = 12,
 	int PNumerator = 1,
-	int PDenominator = 4
+	int PDenominator = 4,
+	class HeightPolicy = XorShiftHeight,
+	class Counters = NullCounters
 >
 class SkipList
 {
 private:
 	static_assert(MaxLevel >= 2, "Max level must be more or equal than 2");
 	static_assert(PNumerator > 0 && PDenominator > 0 && PNumerator < PDenominator, "P must be 0 < P < 1");
+	static_assert(Counters::max_level >= MaxLevel, "Counters must track at least MaxLevel levels");
 
 public:
 	using key_type = Key;
@@ -86,17 +202,28 @@ private:
 	using byte_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::byte>;
 	using byte_traits = std::allocator_traits<byte_alloc>;
 
+	// Arena allocated nodes are released in bulk, per node deallocation is skipped.
+	static constexpr bool arena_nodes = is_arena_allocator_v<byte_alloc>;
+
+	// The list attaches to its arena while it has a head and only rewinds it
+	// while it is the sole holder. Lists sharing the arena (merged, or built
+	// from one allocator) and outstanding node handles keep it from
+	// rewinding; their nodes are then only freed with the arena.
+	bool owns_arena() const noexcept { return m_byte_alloc.arena().holders() == 1; }
+
+	using key_prefix = SkipListKeyPrefix<Key, Compare>;
+	using prefix_type = typename key_prefix::type;
+
 	struct Node
 	{
 		value_type kv;
+		[[no_unique_address]] prefix_type prefix;
 		uint8_t height = 1;
 		Node* next[1];
 
-		Node(const value_type& v, uint8_t h)
-			: kv(v), height(h) { }
-
-		Node(value_type&& v, uint8_t h)
-			: kv(std::move(v)), height(h) { }
+		template<class... Args>
+		Node(uint8_t h, Args&&... args)
+			: kv(std::forward<Args>(args)...), prefix(key_prefix::make(kv.first)), height(h) { }
 	};
 
 	static constexpr size_t node_bytes(uint8_t height) noexcept
@@ -104,18 +231,21 @@ private:
 		return sizeof(Node) + (static_cast<size_t>(height) - 1) * sizeof(Node*);
 	}
 
-	template<class T>
-	Node* create_node(T&& t, uint8_t height)
+	using path_type = std::array<Node*, MaxLevel>;
+
+	template<class... Args>
+	Node* create_node(uint8_t height, Args&&... args)
 	{
 		assert(height >= 1 && height <= MaxLevel);
 
 		const size_t bytes = node_bytes(height);
 		std::byte* memory = byte_traits::allocate(m_byte_alloc, bytes);
+		m_counters.allocate(bytes);
 
 		Node* n = nullptr;
 		try
 		{
-			n = ::new (static_cast<void*>(memory)) Node(std::forward<T>(t), height);
+			n = ::new (static_cast<void*>(memory)) Node(height, std::forward<Args>(args)...);
 			for (size_t i = 0; i < height; ++i)
 			{
 				n->next[i] = nullptr;
@@ -140,27 +270,73 @@ private:
 
 		n->~Node();
 		byte_traits::deallocate(m_byte_alloc, memory, bytes);
+		m_counters.deallocate(bytes);
 	}
 
-	static constexpr bool key_less(const Compare& comp, const Key& a, const Key& b)
+	template<class A, class B>
+	static constexpr bool key_less(const Compare& comp, const A& a, const B& b)
 	{
 		return comp(a, b);
 	}
 
-	static constexpr bool key_eq(const Compare& comp, const Key& a, const Key& b)
+	template<class A, class B>
+	static constexpr bool key_eq(const Compare& comp, const A& a, const B& b)
 	{
 		return !comp(a, b) && !comp(b, a);
 	}
 
+	// Heterogeneous keys only take the prefix path when they are byte strings.
+	template<class K>
+	static constexpr bool prefix_usable = key_prefix::enabled && std::is_convertible_v<const K&, std::string_view>;
+
+	template<class K>
+	static prefix_type make_prefix(const K& key) noexcept
+	{
+		if constexpr (prefix_usable<K>)
+			return key_prefix::make(key);
+		else
+			return prefix_type{};
+	}
+
+	// n->kv.first < key, kp being the prefix of key
+	template<class K>
+	static constexpr bool node_less(const Compare& comp, const Node* n, const K& key, const prefix_type& kp)
+	{
+		if constexpr (prefix_usable<K>)
+		{
+			if (n->prefix != kp)
+				return n->prefix < kp;
+		}
+		return comp(n->kv.first, key);
+	}
+
+	// key < n->kv.first, kp being the prefix of key
+	template<class K>
+	static constexpr bool less_node(const Compare& comp, const K& key, const prefix_type& kp, const Node* n)
+	{
+		if constexpr (prefix_usable<K>)
+		{
+			if (n->prefix != kp)
+				return kp < n->prefix;
+		}
+		return comp(key, n->kv.first);
+	}
+
 public:
 	using iterator = SkipListIterator<Node*, value_type&, value_type*>;
 	using const_iterator = SkipListIterator<const Node*, const value_type&, const value_type*>;
 
+private:
+	template<class K>
+	static constexpr bool transparent_key = requires { typename Compare::is_transparent; }
+		&& !std::is_convertible_v<const K&, iterator> && !std::is_convertible_v<const K&, const_iterator>;
+
+public:
 	SkipList()
 		: SkipList(Compare{}, Alloc{}) { }
 
 	explicit SkipList(const Compare& comp, const Alloc& alloc = Alloc{})
-		: m_comp(comp), m_alloc(alloc), m_byte_alloc(alloc), m_rng(std::random_device{}()) 
+		: m_comp(comp), m_alloc(alloc), m_byte_alloc(alloc) 
 	{
 		ini_head();
 	}
@@ -168,12 +344,19 @@ public:
 	SkipList(const SkipList& other)
 		: m_comp(other.m_comp),
 		m_alloc(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.m_alloc)),
-		m_byte_alloc(m_alloc),
-		m_rng(std::random_device{}()) 
+		m_byte_alloc(m_alloc) 
 	{
 		ini_head();
-		for (const auto& kv : other)
-			insert(kv);
+		try
+		{
+			copy_nodes(other);
+		}
+		catch (...)
+		{
+			clear();
+			destroy_head();
+			throw;
+		}
 	}
 
 	SkipList& operator=(const SkipList& other) 
@@ -184,17 +367,28 @@ public:
 		clear();
 		if constexpr (std::allocator_traits<Alloc>::propagate_on_container_copy_assignment::value) 
 		{
+			destroy_head();
 			m_alloc = other.m_alloc;
-			m_byte_alloc = byte_alloc(m_byte_alloc);
+			m_byte_alloc = byte_alloc(m_alloc);
 		}
 		m_comp = other.m_comp;
 
-		for (const auto& kv : other) 
-			insert(kv);
+		if (!m_head)
+			ini_head();
 
+		copy_nodes(other);
 		return *this;
 	}
 
+	// Copy into the given allocator, e.g. an ArenaAllocator with a block size
+	// picked for the snapshot. Same single pass as the copy constructor.
+	SkipList clone(const Alloc& alloc) const
+	{
+		SkipList list(m_comp, alloc);
+		list.copy_nodes(*this);
+		return list;
+	}
+
 	SkipList(SkipList&& other) noexcept
 		: m_comp(std::move(other.m_comp)),
 		m_alloc(std::move(other.m_alloc)),
@@ -202,11 +396,15 @@ public:
 		m_head(other.m_head),
 		m_level(other.m_level),
 		m_size(other.m_size),
-		m_rng(std::move(other.m_rng)) 
+		m_stamp(other.m_stamp),
+		m_height_counts(other.m_height_counts),
+		m_height(std::move(other.m_height)),
+		m_counters(std::move(other.m_counters))
 	{
 		other.m_head = nullptr;
 		other.m_level = 1;
 		other.m_size = 0;
+		other.m_height_counts.fill(0);
 	}
 
 	SkipList& operator=(SkipList&& other) noexcept 
@@ -227,11 +425,15 @@ public:
 		m_head = other.m_head;
 		m_level = other.m_level;
 		m_size = other.m_size;
-		m_rng = std::move(other.m_rng);
+		m_stamp = other.m_stamp;
+		m_height_counts = other.m_height_counts;
+		m_height = std::move(other.m_height);
+		m_counters = std::move(other.m_counters);
 
 		other.m_head = nullptr;
 		other.m_level = 1;
 		other.m_size = 0;
+		other.m_height_counts.fill(0);
 		return *this;
 	}
 
@@ -247,6 +449,53 @@ public:
 	bool empty() const noexcept { return m_size == 0; }
 	size_type size() const noexcept { return m_size; }
 
+	// Hot path counts gathered by the Counters policy, see SkipListCounters.h.
+	const Counters& counters() const noexcept { return m_counters; }
+	Counters& counters() noexcept { return m_counters; }
+
+	// O(MaxLevel), the per height counts are kept up to date by every link
+	// and unlink. The search path estimate walks the levels top down: on level
+	// i a lookup passes on average the (N_i - N_{i+1}) / (N_{i+1} + 1) nodes
+	// between two towers of the level above, plus the one that stops it,
+	// N_i being the number of nodes reaching level i.
+	SkipListStats<MaxLevel> stats() const noexcept
+	{
+		SkipListStats<MaxLevel> s{};
+		s.size = m_size;
+		s.level = m_level;
+		s.nodes_per_height = m_height_counts;
+		s.node_bytes = m_head ? node_bytes(m_head->height) : 0;
+
+		size_t links = 0;
+		for (int h = 1; h <= MaxLevel; ++h)
+		{
+			const size_t n = m_height_counts[h - 1];
+			if (n == 0)
+				continue;
+
+			s.node_bytes += n * node_bytes((uint8_t)h);
+			s.max_height = (uint8_t)h;
+			links += n * h;
+		}
+
+		if (m_size == 0)
+			return s;
+
+		s.average_height = (double)links / m_size;
+
+		size_t above = 0;
+		for (int i = MaxLevel - 1; i >= 0; --i)
+		{
+			const size_t on_level = above + m_height_counts[i];
+			if (i < m_level)
+				s.expected_search_path += (double)(on_level - above) / (above + 1) + 1.0;
+
+			above = on_level;
+		}
+
+		return s;
+	}
+
 	iterator begin() noexcept { return iterator(m_head->next[0]); }
 	iterator end() noexcept { return iterator(nullptr); }
 	const_iterator begin() const noexcept { return const_iterator(m_head->next[0]); }
@@ -259,12 +508,31 @@ public:
 		if (!m_head) 
 			return;
 
-		Node* cur = m_head->next[0];
-		while (cur) 
+		if constexpr (arena_nodes)
+		{
+			if constexpr (!std::is_trivially_destructible_v<value_type>)
+			{
+				Node* cur = m_head->next[0];
+				while (cur)
+				{
+					Node* nxt = cur->next[0];
+					cur->~Node();
+					cur = nxt;
+				}
+			}
+
+			if (owns_arena())
+				m_byte_alloc.arena().reset();
+		}
+		else
 		{
-			Node* nxt = cur->next[0];
-			destroy_node(cur);
-			cur = nxt;
+			Node* cur = m_head->next[0];
+			while (cur) 
+			{
+				Node* nxt = cur->next[0];
+				destroy_node(cur);
+				cur = nxt;
+			}
 		}
 
 		for (std::size_t i = 0; i < MaxLevel; ++i) 
@@ -272,202 +540,1395 @@ public:
 
 		m_level = 1;
 		m_size = 0;
+		m_height_counts.fill(0);
+		++m_stamp;
 	}
 
-	std::pair<iterator, bool> insert(const value_type& v) { return emplace_impl(v); }
-	std::pair<iterator, bool> insert(value_type&& v) { return emplace_impl(std::move(v)); }
-
-	std::pair<iterator, bool> insert_or_assign(const Key& key, Value value) 
+	// clear() for very large lists: splits level 0 at evenly spaced nodes of a
+	// sparse upper level and destroys the pieces on `threads` threads
+	// (0 = hardware_concurrency). Alloc must tolerate concurrent deallocate().
+	// Arena lists only run the destructors in parallel, instrumented lists
+	// fall back to clear().
+	void clear_parallel(unsigned threads = 0)
 	{
-		auto it = find(key);
-		if (it != end()) 
+		if (!m_head)
+			return;
+
+		const unsigned workers = worker_count(threads, m_size);
+		constexpr bool destructors_only = arena_nodes && std::is_trivially_destructible_v<value_type>;
+		if (workers <= 1 || destructors_only || Counters::enabled)
 		{
-			it->second = std::move(value);
-			return { it, false };
+			clear();
+			return;
 		}
 
-		return insert(value_type{ key, std::move(value) });
-	}
+		// Highest level still holding a few nodes per worker, walked once to
+		// find the split points.
+		size_t level = 0;
+		size_t above = 0;
+		for (size_t i = MaxLevel; i-- > 0; )
+		{
+			above += m_height_counts[i];
+			if (above >= size_t(workers) * 4)
+			{
+				level = i;
+				break;
+			}
+		}
 
-	std::pair<iterator, bool> erase(const key_type& v) { return erase_impl(v); }
+		std::vector<Node*> spine;
+		spine.reserve(above);
+		for (Node* x = m_head->next[level]; x; x = x->next[level])
+			spine.push_back(x);
 
-	iterator erase(iterator pos)
-	{
-		if (pos == end())
-			return end();
+		std::vector<Node*> starts(workers + 1, nullptr);
+		starts[0] = m_head->next[0];
+		for (unsigned w = 1; w < workers; ++w)
+			starts[w] = spine[spine.size() * w / workers];
 
-		auto [it, erased] = erase_impl(pos->first);
-		return it;
-	}
+		parallel_run(workers, [&](unsigned w)
+			{
+				if constexpr (arena_nodes)
+				{
+					for (Node* x = starts[w]; x != starts[w + 1]; x = x->next[0])
+						x->~Node();
+				}
+				else
+				{
+					destroy_chain(starts[w], starts[w + 1]);
+				}
+			});
+
+		if constexpr (arena_nodes)
+		{
+			if (owns_arena())
+				m_byte_alloc.arena().reset();
+		}
 
-	iterator find(const Key& key) noexcept 
-	{
-		Node* x = find_ge(key);
-		if (x && key_eq(m_comp, x->kv.first, key)) 
-			return iterator(x);
+		for (std::size_t i = 0; i < MaxLevel; ++i)
+			m_head->next[i] = nullptr;
 
-		return end();
+		m_level = 1;
+		m_size = 0;
+		m_height_counts.fill(0);
+		++m_stamp;
 	}
-	const_iterator find(const Key& key) const noexcept 
+
+	// Replaces the contents with the sorted range [first, last) in one pass,
+	// appending every node at the tail of each level. Equal neighbours are
+	// dropped like insert() would. `balanced` gives every k-th node (k = 1/P)
+	// an extra level instead of drawing heights at random.
+	template<class It>
+	void assign_sorted(It first, It last, bool balanced = false)
 	{
-		const Node* x = find_ge_const(key);
-		if (x && key_eq(m_comp, x->kv.first, key)) 
-			return const_iterator(x);
+		clear();
 
-		return end();
-	}
+		path_type tails{};
+		tails.fill(m_head);
 
-	bool contains(const Key& key) const noexcept 
-	{
-		return find(key) != end();
-	}
+		size_t index = 0;
+		for (; first != last; ++first)
+		{
+			const auto& kv = *first;
+			if (tails[0] != m_head)
+			{
+				assert(!key_less(m_comp, kv.first, tails[0]->kv.first) && "assign_sorted input must be sorted");
+				if (!key_less(m_comp, tails[0]->kv.first, kv.first))
+					continue;
+			}
 
-	iterator lower_bound(const Key& key) noexcept 
-	{
-		return iterator(find_ge(key));
-	}
-	const_iterator lower_bound(const Key& key) const noexcept 
-	{
-		return const_iterator(find_ge_const(key));
+			const uint8_t h = balanced ? balanced_height(++index) : random_height(kv.first);
+			Node* n = create_node(h, kv);
+
+			for (size_t i = 0; i < h; ++i)
+			{
+				tails[i]->next[i] = n;
+				tails[i] = n;
+			}
+
+			if (h > m_level)
+				m_level = h;
+
+			++m_height_counts[h - 1];
+			++m_size;
+		}
+
+		++m_stamp;
 	}
 
-private:
-	void ini_head() 
+	template<class It>
+	static SkipList from_sorted(It first, It last, bool balanced = false, const Compare& comp = Compare{}, const Alloc& alloc = Alloc{})
 	{
-		value_type dummy{ Key{}, Value{} };
-		m_head = create_node(std::move(dummy), (uint8_t)(MaxLevel));
-		m_level = 1;
-		m_size = 0;
+		SkipList list(comp, alloc);
+		list.assign_sorted(first, last, balanced);
+		return list;
 	}
 
-	void destroy_head() noexcept 
+	// Parallel bulk load of an unsorted range: the input is copied out, sorted
+	// on `threads` threads (0 = hardware_concurrency), each thread then builds
+	// and links the nodes of one slice of the sorted keys and the slices are
+	// stitched together level by level. Duplicates keep their first
+	// occurrence, like repeated insert() would.
+	//
+	// Alloc must tolerate concurrent allocate() calls. Lists with an arena or
+	// enabled Counters, neither of which is thread safe, sort in parallel and
+	// build on the calling thread. Height policies that ignore the key draw
+	// from one XorShiftHeight per thread instead of the list's own generator.
+	template<class It>
+	void assign_unsorted(It first, It last, unsigned threads = 0, bool balanced = false)
 	{
-		if (!m_head) 
+		clear();
+
+		std::vector<std::pair<Key, Value>> items(first, last);
+		if (items.empty())
 			return;
 
-		destroy_node(m_head);
-		m_head = nullptr;
-	}
+		const auto item_less = [this](const auto& a, const auto& b) { return key_less(m_comp, a.first, b.first); };
+		parallel_stable_sort(items, worker_count(threads, items.size()), item_less);
 
-	Node* find_ge(const Key& key) noexcept 
-	{
-		Node* x = m_head;
-		for (int i = (int)(m_level) - 1; i >= 0; --i)
+		constexpr bool serial_build = arena_nodes || Counters::enabled;
+		const unsigned workers = serial_build ? 1u : worker_count(threads, items.size());
+
+		auto slice = [&](unsigned w) { return items.size() * w / workers; };
+
+		// Duplicates are marked before anything is moved out of items, the
+		// per-slice counts give balanced heights their global index so the
+		// layout does not depend on the thread count.
+		std::vector<char> keep(items.size());
+		std::vector<size_t> offsets(workers + 1, 0);
+		parallel_run(workers, [&](unsigned w)
+			{
+				size_t kept = 0;
+				for (size_t i = slice(w); i < slice(w + 1); ++i)
+				{
+					keep[i] = i == 0 || key_less(m_comp, items[i - 1].first, items[i].first);
+					kept += keep[i];
+				}
+				offsets[w + 1] = kept;
+			});
+		for (unsigned w = 0; w < workers; ++w)
+			offsets[w + 1] += offsets[w];
+
+		std::vector<Segment> segments(workers);
+		parallel_run(workers, [&](unsigned w)
+			{
+				Segment& s = segments[w];
+				try
+				{
+					XorShiftHeight local;
+					size_t index = offsets[w];
+					for (size_t i = slice(w); i < slice(w + 1); ++i)
+					{
+						if (!keep[i])
+							continue;
+
+						uint8_t h;
+						if (balanced)
+							h = balanced_height(++index);
+						else if constexpr (HeightPolicy::uses_key)
+							h = m_height.template height<MaxLevel, PNumerator, PDenominator>(items[i].first);
+						else
+							h = local.template height<MaxLevel, PNumerator, PDenominator>(items[i].first);
+
+						s.append(create_node(h, std::move(items[i])));
+					}
+				}
+				catch (...)
+				{
+					s.error = std::current_exception();
+				}
+			});
+
+		std::exception_ptr error;
+		for (Segment& s : segments)
 		{
-			while (x->next[i] && key_less(m_comp, x->next[i]->kv.first, key)) 
-				x = x->next[i];
+			if (s.error && !error)
+				error = s.error;
 		}
 
-		return x->next[0];
-	}
-
-	const Node* find_ge_const(const Key& key) const noexcept 
-	{
-		const Node* x = m_head;
-		for (int i = (int)(m_level) - 1; i >= 0; --i) 
+		if (error)
 		{
-			while (x->next[i] && key_less(m_comp, x->next[i]->kv.first, key)) 
-				x = x->next[i];
+			for (Segment& s : segments)
+				destroy_chain(s.first[0], nullptr);
+			std::rethrow_exception(error);
 		}
 
-		return x->next[0];
-	}
+		path_type tails{};
+		tails.fill(m_head);
 
-	uint8_t random_height() 
-	{
-		uint8_t h = 1;
-		while (h < MaxLevel) 
+		for (Segment& s : segments)
 		{
-			uint32_t r = m_dist(m_rng);
-			if ((r % PDenominator) >= PNumerator) 
-				break;
+			for (size_t i = 0; i < MaxLevel; ++i)
+			{
+				if (!s.first[i])
+					continue;
 
-			++h;
+				tails[i]->next[i] = s.first[i];
+				tails[i] = s.last[i];
+			}
+
+			for (size_t i = 0; i < MaxLevel; ++i)
+				m_height_counts[i] += s.height_counts[i];
+
+			m_size += s.size;
+			if (s.level > m_level)
+				m_level = s.level;
 		}
-		return h;
+
+		++m_stamp;
 	}
 
-	template <class V>
-	std::pair<iterator, bool> emplace_impl(V&& v) 
+	template<class It>
+	static SkipList from_unsorted(It first, It last, unsigned threads = 0, bool balanced = false, const Compare& comp = Compare{}, const Alloc& alloc = Alloc{})
 	{
-		std::array<Node*, MaxLevel> update{};
-		Node* x = m_head;
-
-		for (int i = (int)(m_level) - 1; i >= 0; --i) 
-		{
-			while (x->next[i] && key_less(m_comp, x->next[i]->kv.first, v.first)) 
-				x = x->next[i];
-
-			update[i] = x;
-		}
+		SkipList list(comp, alloc);
+		list.assign_unsorted(first, last, threads, balanced);
+		return list;
+	}
 
-		x = x->next[0];
-		if (x && key_eq(m_comp, x->kv.first, v.first))
-			return { iterator(x), false };
+	std::pair<iterator, bool> insert(const value_type& v) { return emplace_impl(v); }
+	std::pair<iterator, bool> insert(value_type&& v) { return emplace_impl(std::move(v)); }
 
-		uint8_t h = random_height();
-		if (h > m_level) 
+	// All of the following search once and construct the value in place only
+	// when a node is actually created.
+	template<class... Args>
+	std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) { return try_emplace_impl(key, std::forward<Args>(args)...); }
+	template<class... Args>
+	std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) { return try_emplace_impl(std::move(key), std::forward<Args>(args)...); }
+
+	template<class M>
+	std::pair<iterator, bool> insert_or_assign(const Key& key, M&& value) { return insert_or_assign_impl(key, std::forward<M>(value)); }
+	template<class M>
+	std::pair<iterator, bool> insert_or_assign(Key&& key, M&& value) { return insert_or_assign_impl(std::move(key), std::forward<M>(value)); }
+	// Braced values cannot deduce M, these keep insert_or_assign(key, { ... })
+	// working.
+	std::pair<iterator, bool> insert_or_assign(const Key& key, const Value& value) { return insert_or_assign_impl(key, value); }
+	std::pair<iterator, bool> insert_or_assign(const Key& key, Value&& value) { return insert_or_assign_impl(key, std::move(value)); }
+
+	// A (key, mapped) argument pair takes the try_emplace path, anything else
+	// has to build the node first to learn its key.
+	template<class... Args>
+	std::pair<iterator, bool> emplace(Args&&... args)
+	{
+		if constexpr (sizeof...(Args) == 2 && std::is_same_v<std::remove_cvref_t<std::tuple_element_t<0, std::tuple<Args...>>>, Key>)
 		{
-			for (size_t i = m_level; i < h; ++i) 
-				update[i] = m_head;
-
-			m_level = h;
+			return emplace_key_first(std::forward<Args>(args)...);
 		}
+		else
+		{
+			Node* n = nullptr;
+			if constexpr (HeightPolicy::uses_key)
+			{
+				value_type tmp(std::forward<Args>(args)...);
+				n = create_node(random_height(tmp.first), std::move(tmp));
+			}
+			else
+			{
+				n = create_node(random_height(nullptr), std::forward<Args>(args)...);
+			}
 
-		Node* n = create_node(std::forward<V>(v), h);
+			path_type update{};
+			Node* x = find_path(n->kv.first, update);
+			if (x && key_eq(m_comp, x->kv.first, n->kv.first))
+			{
+				destroy_node(n);
+				m_counters.insert_conflict();
+				return { iterator(x), false };
+			}
 
-		for (size_t i = 0; i < h; ++i) 
-		{
-			n->next[i] = update[i]->next[i];
-			update[i]->next[i] = n;
+			splice_node(update, n);
+			return { iterator(n), true };
 		}
-
-		++m_size;
-		return { iterator(n), true };
 	}
 
-	template <class V>
-	std::pair<iterator, bool> erase_impl(V&& v)
-	{
-		std::array<Node*, MaxLevel> update{};
-		Node* x = m_head;
+	std::pair<iterator, bool> erase(const key_type& v) { return erase_impl(v); }
 
-		for (int i = (int)(m_level) - 1; i >= 0; --i)
-		{
-			while (x->next[i] && key_less(m_comp, x->next[i]->kv.first, v))
-				x = x->next[i];
+	// Remembers the search path of the last operation made through it, so the
+	// next nearby find/insert/erase resumes from there instead of the head.
+	// Any modification not made through the finger makes it fall back to a
+	// full search once, it never dangles.
+	class finger
+	{
+	public:
+		finger() noexcept = default;
 
-			update[i] = x;
-		}
+	private:
+		friend class SkipList;
 
-		x = x->next[0];
-		if (!x || !key_eq(m_comp, x->kv.first, v))
-			return { iterator(x), false };
+		path_type	m_path{};
+		const Node*	m_head = nullptr;
+		size_t		m_stamp = 0;
+	};
 
-		for (size_t i = 0; i < x->height; ++i)
-			update[i]->next[i] = x->next[i];
+	std::pair<iterator, bool> insert(finger& f, const value_type& v) { return emplace_impl(f, v); }
+	std::pair<iterator, bool> insert(finger& f, value_type&& v) { return emplace_impl(f, std::move(v)); }
+	std::pair<iterator, bool> erase(finger& f, const key_type& v) { return erase_impl(f, v); }
 
-		Node* next = x->next[0];
-		destroy_node(x);
-		--m_size;
+	iterator find(finger& f, const Key& key) noexcept
+	{
+		Node* x = find_path(f, key);
+		if (x && key_eq(m_comp, x->kv.first, key))
+			return iterator(x);
 
-		while (m_level > 1 && m_head->next[m_level - 1] == nullptr)
-			--m_level;
+		return end();
+	}
 
-		return { iterator(next), true };
+	iterator lower_bound(finger& f, const Key& key) noexcept
+	{
+		return iterator(find_path(f, key));
 	}
 
-private:
-	using Random = std::mt19937;
-	using Uint32Dist = std::uniform_int_distribution<uint32_t>;
-	static constexpr uint32_t Uint32Limit = std::numeric_limits<uint32_t>::max();
+	iterator erase(iterator pos)
+	{
+		if (pos == end())
+			return end();
 
+		auto [it, erased] = erase_impl(pos->first);
+		return it;
+	}
+
+	// Owning handle to a node taken out of a list by extract(). The node keeps
+	// its key, value and tower height, inserting it into a list with an equal
+	// allocator relinks it without allocating. A handle still holding its
+	// node destroys it.
+	class node_type
+	{
+	public:
+		using key_type = Key;
+		using mapped_type = Value;
+		using allocator_type = Alloc;
+
+		node_type() noexcept = default;
+
+		node_type(node_type&& other) noexcept
+			: m_node(std::exchange(other.m_node, nullptr)), m_alloc(std::move(other.m_alloc)) { }
+
+		node_type& operator=(node_type&& other) noexcept
+		{
+			if (this != &other)
+			{
+				reset();
+				m_node = std::exchange(other.m_node, nullptr);
+				m_alloc = std::move(other.m_alloc);
+			}
+			return *this;
+		}
+
+		node_type(const node_type&) = delete;
+		node_type& operator=(const node_type&) = delete;
+
+		~node_type()
+		{
+			reset();
+		}
+
+		bool empty() const noexcept { return m_node == nullptr; }
+		explicit operator bool() const noexcept { return m_node != nullptr; }
+
+		// The key is read only, the node caches derived data (the key
+		// prefix) that a changed key would invalidate.
+		const key_type& key() const noexcept { return m_node->kv.first; }
+		mapped_type& mapped() const noexcept { return m_node->kv.second; }
+
+		allocator_type get_allocator() const { return allocator_type(*m_alloc); }
+
+	private:
+		friend class SkipList;
+
+		// A non-empty handle holds its arena like a list does, so the list it
+		// came from cannot rewind the node away.
+		node_type(Node* n, const byte_alloc& alloc)
+			: m_node(n), m_alloc(alloc)
+		{
+			if constexpr (arena_nodes)
+				m_alloc->arena().attach();
+		}
+
+		void reset() noexcept
+		{
+			if (!m_node)
+				return;
+
+			const size_t bytes = node_bytes(m_node->height);
+			m_node->~Node();
+			byte_traits::deallocate(*m_alloc, reinterpret_cast<std::byte*>(m_node), bytes);
+			release();
+		}
+
+		// Gives up the node without destroying it.
+		Node* release() noexcept
+		{
+			if constexpr (arena_nodes)
+				m_alloc->arena().detach();
+			return std::exchange(m_node, nullptr);
+		}
+
+		Node*						m_node = nullptr;
+		std::optional<byte_alloc>	m_alloc;
+	};
+
+	struct insert_return_type
+	{
+		iterator	position;
+		bool		inserted = false;
+		node_type	node;
+	};
+
+	// Unlinks the entry and hands it over, an empty handle when key is missing.
+	node_type extract(const Key& key)
+	{
+		path_type update{};
+
+		Node* x = find_path(key, update);
+		if (!x || !key_eq(m_comp, x->kv.first, key))
+		{
+			m_counters.erase_miss();
+			return node_type();
+		}
+
+		detach_node(update, x);
+		m_counters.erase();
+		return node_type(x, m_byte_alloc);
+	}
+
+	node_type extract(const_iterator pos)
+	{
+		assert(pos != cend() && "extract(end())");
+		return extract(pos->first);
+	}
+
+	node_type extract(iterator pos)
+	{
+		return extract(const_iterator(pos.node()));
+	}
+
+	// Links the handle's node in place, keeping its height. When the key is
+	// already present the handle is returned untouched in .node. A handle
+	// from a list with a different allocator has its entry moved into a
+	// fresh node instead.
+	insert_return_type insert(node_type&& nh)
+	{
+		if (nh.empty())
+			return { end(), false, node_type() };
+
+		if (!(*nh.m_alloc == m_byte_alloc))
+		{
+			auto [it, inserted] = emplace_impl(std::move(nh.m_node->kv));
+			if (!inserted)
+				return { it, false, std::move(nh) };
+
+			nh.reset();
+			return { it, true, node_type() };
+		}
+
+		path_type update{};
+		Node* x = find_path(nh.key(), update);
+		if (x && key_eq(m_comp, x->kv.first, nh.key()))
+		{
+			m_counters.insert_conflict();
+			return { iterator(x), false, std::move(nh) };
+		}
+
+		Node* n = nh.release();
+		splice_node(update, n);
+		return { iterator(n), true, node_type() };
+	}
+
+	// Moves every entry of other whose key is not present here into this
+	// list, std::map::merge style; conflicting entries stay in other. Both
+	// lists are walked once in key order and the nodes are relinked, nothing
+	// is allocated or copied: O(n + m). When the allocators differ the
+	// entries are moved into fresh nodes instead. Lists merged on one arena
+	// share it, neither rewinds it on clear() while the other is alive.
+	void merge(SkipList& other)
+	{
+		if (this == &other || !other.m_head || other.m_size == 0)
+			return;
+
+		if (!(m_byte_alloc == other.m_byte_alloc))
+		{
+			merge_by_value(other);
+			return;
+		}
+
+		// into[i]: last node on level i of this list before the current key,
+		// keep[i]: last node on level i of other that stays there.
+		path_type into{};
+		into.fill(m_head);
+		path_type keep{};
+		keep.fill(other.m_head);
+
+		Node* s = other.m_head->next[0];
+		while (s)
+		{
+			Node* next = s->next[0];
+			const uint8_t h = s->height;
+			const Key& key = s->kv.first;
+
+			// Resume every level from where the previous key left it, or
+			// from the node found one level up when that one is further.
+			// Levels at and above m_level are empty, into[] is still m_head.
+			Node* above = m_head;
+			for (int i = (int)m_level - 1; i >= 0; --i)
+			{
+				Node* x = into[i];
+				if (above != m_head && above != x && (x == m_head || key_less(m_comp, x->kv.first, above->kv.first)))
+					x = above;
+
+				while (x->next[i] && key_less(m_comp, x->next[i]->kv.first, key))
+					x = x->next[i];
+
+				into[i] = x;
+				above = x;
+			}
+
+			Node* y = into[0]->next[0];
+			if (y && key_eq(m_comp, y->kv.first, key))
+			{
+				m_counters.insert_conflict();
+				for (size_t i = 0; i < h; ++i)
+					keep[i] = s;
+			}
+			else
+			{
+				for (size_t i = 0; i < h; ++i)
+				{
+					keep[i]->next[i] = s->next[i];
+					s->next[i] = into[i]->next[i];
+					into[i]->next[i] = s;
+					into[i] = s;
+				}
+
+				--other.m_height_counts[h - 1];
+				--other.m_size;
+				other.m_counters.erase();
+
+				++m_height_counts[h - 1];
+				++m_size;
+				m_counters.insert();
+				if (h > m_level)
+					m_level = h;
+			}
+
+			s = next;
+		}
+
+		while (other.m_level > 1 && other.m_head->next[other.m_level - 1] == nullptr)
+			--other.m_level;
+
+		++m_stamp;
+		++other.m_stamp;
+	}
+
+	void merge(SkipList&& other)
+	{
+		merge(other);
+	}
+
+	iterator find(const Key& key) noexcept 
+	{
+		Node* x = find_ge(key);
+		if (x && key_eq(m_comp, x->kv.first, key)) 
+			return iterator(x);
+
+		return end();
+	}
+	const_iterator find(const Key& key) const noexcept 
+	{
+		const Node* x = find_ge_const(key);
+		if (x && key_eq(m_comp, x->kv.first, key)) 
+			return const_iterator(x);
+
+		return end();
+	}
+
+	// Resolves keys[i] into out[i] (end() when missing). Up to MultiFindLanes
+	// searches advance in lockstep and each prefetches the node it will look
+	// at next, so their cache misses overlap instead of queuing up.
+	void multi_find(std::span<const Key> keys, std::span<iterator> out) noexcept
+	{
+		assert(out.size() >= keys.size());
+
+		multi_find_impl(keys, [&](size_t i, const Node* n) { out[i] = iterator(const_cast<Node*>(n)); });
+	}
+	void multi_find(std::span<const Key> keys, std::span<const_iterator> out) const noexcept
+	{
+		assert(out.size() >= keys.size());
+
+		multi_find_impl(keys, [&](size_t i, const Node* n) { out[i] = const_iterator(n); });
+	}
+
+	bool contains(const Key& key) const noexcept 
+	{
+		return find(key) != end();
+	}
+
+	iterator lower_bound(const Key& key) noexcept 
+	{
+		return iterator(find_ge(key));
+	}
+	const_iterator lower_bound(const Key& key) const noexcept 
+	{
+		return const_iterator(find_ge_const(key));
+	}
+
+	iterator upper_bound(const Key& key) noexcept
+	{
+		return iterator(find_gt(key));
+	}
+	const_iterator upper_bound(const Key& key) const noexcept
+	{
+		return const_iterator(find_gt_const(key));
+	}
+
+	// Heterogeneous lookup, enabled when Compare declares is_transparent (like
+	// std::less<>), so callers holding e.g. a std::string_view do not have to
+	// materialize a Key first.
+	template<class K> requires transparent_key<K>
+	iterator find(const K& key) noexcept
+	{
+		Node* x = find_ge(key);
+		if (x && key_eq(m_comp, x->kv.first, key))
+			return iterator(x);
+
+		return end();
+	}
+	template<class K> requires transparent_key<K>
+	const_iterator find(const K& key) const noexcept
+	{
+		const Node* x = find_ge_const(key);
+		if (x && key_eq(m_comp, x->kv.first, key))
+			return const_iterator(x);
+
+		return end();
+	}
+
+	template<class K> requires transparent_key<K>
+	bool contains(const K& key) const noexcept
+	{
+		return find(key) != end();
+	}
+
+	template<class K> requires transparent_key<K>
+	iterator lower_bound(const K& key) noexcept
+	{
+		return iterator(find_ge(key));
+	}
+	template<class K> requires transparent_key<K>
+	const_iterator lower_bound(const K& key) const noexcept
+	{
+		return const_iterator(find_ge_const(key));
+	}
+
+	template<class K> requires transparent_key<K>
+	iterator upper_bound(const K& key) noexcept
+	{
+		return iterator(find_gt(key));
+	}
+	template<class K> requires transparent_key<K>
+	const_iterator upper_bound(const K& key) const noexcept
+	{
+		return const_iterator(find_gt_const(key));
+	}
+
+	template<class K> requires transparent_key<K>
+	std::pair<iterator, bool> erase(const K& key) { return erase_impl(key); }
+
+	std::pair<iterator, iterator> equal_range(const Key& key) noexcept
+	{
+		Node* x = find_ge(key);
+		if (x && key_eq(m_comp, x->kv.first, key))
+			return { iterator(x), iterator(x->next[0]) };
+
+		return { iterator(x), iterator(x) };
+	}
+	std::pair<const_iterator, const_iterator> equal_range(const Key& key) const noexcept
+	{
+		const Node* x = find_ge_const(key);
+		if (x && key_eq(m_comp, x->kv.first, key))
+			return { const_iterator(x), const_iterator(x->next[0]) };
+
+		return { const_iterator(x), const_iterator(x) };
+	}
+
+	// Entries with lo <= key < hi. The upper bound is found with a finger
+	// search resumed from the lower one.
+	SkipListRange<iterator> range(const Key& lo, const Key& hi) noexcept
+	{
+		if (!key_less(m_comp, lo, hi))
+			return {};
+
+		finger f;
+		Node* first = find_path(f, lo);
+		Node* last = find_path(f, hi);
+		return { iterator(first), iterator(last) };
+	}
+	SkipListRange<const_iterator> range(const Key& lo, const Key& hi) const noexcept
+	{
+		if (!key_less(m_comp, lo, hi))
+			return {};
+
+		return { const_iterator(find_ge_const(lo)), const_iterator(find_ge_const(hi)) };
+	}
+
+	// Erases every entry with lo <= key < hi. Each level is spliced once past
+	// the run, so the cost is one search plus the k erased nodes.
+	size_type erase(const Key& lo, const Key& hi) noexcept
+	{
+		if (!key_less(m_comp, lo, hi))
+			return 0;
+
+		path_type update{};
+		Node* first = find_path(lo, update);
+		if (!first || !key_less(m_comp, first->kv.first, hi))
+			return 0;
+
+		const prefix_type hp = make_prefix(hi);
+		for (int i = 0; i < (int)(m_level); ++i)
+		{
+			Node* n = update[i]->next[i];
+			while (n && node_less(m_comp, n, hi, hp))
+				n = n->next[i];
+
+			update[i]->next[i] = n;
+		}
+
+		Node* stop = update[0]->next[0];
+		size_type erased = 0;
+		while (first != stop)
+		{
+			Node* nxt = first->next[0];
+			--m_height_counts[first->height - 1];
+			destroy_node(first);
+			first = nxt;
+			++erased;
+		}
+
+		m_size -= erased;
+		++m_stamp;
+
+		while (m_level > 1 && m_head->next[m_level - 1] == nullptr)
+			--m_level;
+
+		return erased;
+	}
+
+private:
+	void ini_head() 
+	{
+		value_type dummy{ Key{}, Value{} };
+		m_head = create_node((uint8_t)(MaxLevel), std::move(dummy));
+		if constexpr (arena_nodes)
+		{
+			m_byte_alloc.arena().pin();
+			m_byte_alloc.arena().attach();
+		}
+
+		m_level = 1;
+		m_size = 0;
+	}
+
+	void destroy_head() noexcept 
+	{
+		if (!m_head) 
+			return;
+
+		destroy_node(m_head);
+		m_head = nullptr;
+		if constexpr (arena_nodes)
+			m_byte_alloc.arena().detach();
+	}
+
+	// Appends copies of other's nodes with their heights unchanged, linked in
+	// one pass through a per-level tail array instead of a search per
+	// element. Arena lists first reserve one block for all of them. The list
+	// must be empty.
+	void copy_nodes(const SkipList& other)
+	{
+		assert(m_size == 0);
+		if (!other.m_head)
+			return;
+
+		if constexpr (arena_nodes)
+		{
+			constexpr size_t align = alignof(std::max_align_t);
+
+			size_t bytes = 0;
+			for (size_t i = 0; i < MaxLevel; ++i)
+				bytes += other.m_height_counts[i] * ((node_bytes((uint8_t)(i + 1)) + align - 1) & ~(align - 1));
+			m_byte_alloc.arena().reserve(bytes);
+		}
+
+		path_type tails{};
+		tails.fill(m_head);
+
+		for (const Node* x = other.m_head->next[0]; x; x = x->next[0])
+		{
+			const uint8_t h = x->height;
+			Node* n = create_node(h, x->kv);
+
+			for (size_t i = 0; i < h; ++i)
+			{
+				tails[i]->next[i] = n;
+				tails[i] = n;
+			}
+
+			if (h > m_level)
+				m_level = h;
+
+			++m_height_counts[h - 1];
+			++m_size;
+		}
+
+		++m_stamp;
+	}
+
+	// Comparisons made while descending, reported to the counters.
+	template<class K>
+	bool step_less(const Node* n, const K& key, const prefix_type& kp) const noexcept
+	{
+		m_counters.compare();
+		return node_less(m_comp, n, key, kp);
+	}
+
+	template<class K>
+	bool step_not_greater(const Node* n, const K& key, const prefix_type& kp) const noexcept
+	{
+		m_counters.compare();
+		return !less_node(m_comp, key, kp, n);
+	}
+
+	template<class K>
+	Node* find_ge(const K& key) noexcept 
+	{
+		m_counters.search();
+		const prefix_type kp = make_prefix(key);
+		Node* x = m_head;
+		for (int i = (int)(m_level) - 1; i >= 0; --i)
+		{
+			while (x->next[i] && step_less(x->next[i], key, kp))
+			{
+				x = x->next[i];
+				m_counters.visit(i);
+			}
+		}
+
+		return x->next[0];
+	}
+
+	template<class K>
+	const Node* find_ge_const(const K& key) const noexcept 
+	{
+		m_counters.search();
+		const prefix_type kp = make_prefix(key);
+		const Node* x = m_head;
+		for (int i = (int)(m_level) - 1; i >= 0; --i) 
+		{
+			while (x->next[i] && step_less(x->next[i], key, kp))
+			{
+				x = x->next[i];
+				m_counters.visit(i);
+			}
+		}
+
+		return x->next[0];
+	}
+
+	template<class K>
+	Node* find_gt(const K& key) noexcept
+	{
+		m_counters.search();
+		const prefix_type kp = make_prefix(key);
+		Node* x = m_head;
+		for (int i = (int)(m_level) - 1; i >= 0; --i)
+		{
+			while (x->next[i] && step_not_greater(x->next[i], key, kp))
+			{
+				x = x->next[i];
+				m_counters.visit(i);
+			}
+		}
+
+		return x->next[0];
+	}
+
+	template<class K>
+	const Node* find_gt_const(const K& key) const noexcept
+	{
+		m_counters.search();
+		const prefix_type kp = make_prefix(key);
+		const Node* x = m_head;
+		for (int i = (int)(m_level) - 1; i >= 0; --i)
+		{
+			while (x->next[i] && step_not_greater(x->next[i], key, kp))
+			{
+				x = x->next[i];
+				m_counters.visit(i);
+			}
+		}
+
+		return x->next[0];
+	}
+
+	static constexpr size_t MultiFindLanes = 16;
+
+	static void prefetch(const void* p) noexcept
+	{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		_mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#elif defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(p);
+#else
+		(void)p;
+#endif
+	}
+
+	template<class Out>
+	void multi_find_impl(std::span<const Key> keys, Out&& out) const noexcept
+	{
+		struct Lane
+		{
+			const Node* x;
+			int level;
+		};
+
+		for (size_t base = 0; base < keys.size(); base += MultiFindLanes)
+		{
+			const size_t count = std::min(MultiFindLanes, keys.size() - base);
+
+			std::array<Lane, MultiFindLanes> lanes;
+			std::array<prefix_type, MultiFindLanes> prefixes;
+			for (size_t l = 0; l < count; ++l)
+			{
+				lanes[l] = { m_head, (int)(m_level) - 1 };
+				prefixes[l] = make_prefix(keys[base + l]);
+			}
+
+			size_t active = count;
+			while (active)
+			{
+				for (size_t l = 0; l < count; ++l)
+				{
+					Lane& lane = lanes[l];
+					if (lane.level < 0)
+						continue;
+
+					const Key& key = keys[base + l];
+					const Node* nxt = lane.x->next[lane.level];
+					if (nxt && node_less(m_comp, nxt, key, prefixes[l]))
+					{
+						lane.x = nxt;
+						if (const Node* ahead = nxt->next[lane.level])
+							prefetch(ahead);
+						continue;
+					}
+
+					if (lane.level == 0)
+					{
+						out(base + l, (nxt && key_eq(m_comp, nxt->kv.first, key)) ? nxt : nullptr);
+						lane.level = -1;
+						--active;
+						continue;
+					}
+
+					--lane.level;
+					if (const Node* below = lane.x->next[lane.level])
+						prefetch(below);
+				}
+			}
+		}
+	}
+
+	// One thread's share of assign_unsorted(): its nodes linked among
+	// themselves, first[i] / last[i] are the ends of level i.
+	struct Segment
+	{
+		path_type					first{};
+		path_type					last{};
+		std::array<size_t, MaxLevel> height_counts{};
+		size_t						size = 0;
+		uint8_t						level = 0;
+		std::exception_ptr			error;
+
+		void append(Node* n) noexcept
+		{
+			for (size_t i = 0; i < n->height; ++i)
+			{
+				if (last[i])
+					last[i]->next[i] = n;
+				else
+					first[i] = n;
+				last[i] = n;
+			}
+
+			++height_counts[n->height - 1];
+			++size;
+			if (n->height > level)
+				level = n->height;
+		}
+	};
+
+	// Below a few thousand elements per thread spawning costs more than it saves.
+	static unsigned worker_count(unsigned threads, size_t n) noexcept
+	{
+		constexpr size_t grain = 4096;
+
+		if (threads == 0)
+			threads = std::max(1u, std::thread::hardware_concurrency());
+
+		return (unsigned)std::max<size_t>(1, std::min<size_t>(threads, n / grain));
+	}
+
+	// Runs f(0) .. f(workers - 1), f(0) on the calling thread. Exceptions are
+	// caught per worker and the first one is rethrown once all have joined,
+	// one escaping a jthread would call std::terminate.
+	template<class F>
+	static void parallel_run(unsigned workers, F&& f)
+	{
+		std::vector<std::exception_ptr> errors(workers);
+		auto run = [&f, &errors](unsigned w)
+			{
+				try
+				{
+					f(w);
+				}
+				catch (...)
+				{
+					errors[w] = std::current_exception();
+				}
+			};
+
+		{
+			std::vector<std::jthread> pool;
+			pool.reserve(workers - 1);
+			for (unsigned w = 1; w < workers; ++w)
+				pool.emplace_back(run, w);
+
+			run(0);
+		}
+
+		for (const std::exception_ptr& e : errors)
+		{
+			if (e)
+				std::rethrow_exception(e);
+		}
+	}
+
+	// Stable sorts equal slices on their own threads, then merges neighbouring
+	// runs pairwise, halving the number of runs each round.
+	template<class T, class Less>
+	static void parallel_stable_sort(std::vector<T>& items, unsigned workers, Less less)
+	{
+		auto bound = [&](unsigned w) { return items.begin() + items.size() * std::min(w, workers) / workers; };
+
+		parallel_run(workers, [&](unsigned w) { std::stable_sort(bound(w), bound(w + 1), less); });
+
+		for (unsigned width = 1; width < workers; width *= 2)
+		{
+			const unsigned merges = (workers + 2 * width - 1) / (2 * width);
+			parallel_run(merges, [&](unsigned m)
+				{
+					const unsigned lo = m * 2 * width;
+					if (lo + width < workers)
+						std::inplace_merge(bound(lo), bound(lo + width), bound(lo + 2 * width), less);
+				});
+		}
+	}
+
+	// Destroys the level 0 chain [first, last).
+	void destroy_chain(Node* first, Node* last) noexcept
+	{
+		while (first != last)
+		{
+			Node* nxt = first->next[0];
+			destroy_node(first);
+			first = nxt;
+		}
+	}
+
+	// Height of the index-th (1-based) node of a perfectly balanced list.
+	static uint8_t balanced_height(size_t index) noexcept
+	{
+		constexpr size_t rounded = (PDenominator + PNumerator / 2) / PNumerator;
+		constexpr size_t ratio = rounded < 2 ? 2 : rounded;
+
+		uint8_t h = 1;
+		while (h < MaxLevel && index % ratio == 0)
+		{
+			index /= ratio;
+			++h;
+		}
+		return h;
+	}
+
+	// Policies that ignore the key may be handed a nullptr instead.
+	template<class K>
+	uint8_t random_height(const K& key)
+	{
+		return m_height.template height<MaxLevel, PNumerator, PDenominator>(key);
+	}
+
+	// Fills update[i] with the last node before `key` on every live level and
+	// returns the first node not less than `key`.
+	template<class K>
+	Node* find_path(const K& key, path_type& update) noexcept
+	{
+		m_counters.search();
+		const prefix_type kp = make_prefix(key);
+		Node* x = m_head;
+
+		for (int i = (int)(m_level) - 1; i >= 0; --i)
+		{
+			while (x->next[i] && step_less(x->next[i], key, kp))
+			{
+				x = x->next[i];
+				m_counters.visit(i);
+			}
+
+			update[i] = x;
+		}
+
+		return x->next[0];
+	}
+
+	// Resumes the search from the path a finger recorded. Climbs only until a
+	// level whose predecessor brackets `key`, so the cost is O(log d) in the
+	// distance to the previous key instead of O(log n).
+	Node* find_path(finger& f, const Key& key) noexcept
+	{
+		auto& path = f.m_path;
+
+		if (f.m_head != m_head || f.m_stamp != m_stamp)
+		{
+			path.fill(m_head);
+			f.m_head = m_head;
+			f.m_stamp = m_stamp;
+			return find_path(key, path);
+		}
+
+		m_counters.search();
+		const prefix_type kp = make_prefix(key);
+		const int top = (int)(m_level) - 1;
+		int t = 0;
+		for (; t < top; ++t)
+		{
+			const Node* p = path[t];
+			if (p != m_head && !node_less(m_comp, p, key, kp))
+				continue;
+
+			const Node* n = p->next[t];
+			if (!n || !node_less(m_comp, n, key, kp))
+				break;
+		}
+
+		Node* x = path[t];
+		if (x != m_head && !node_less(m_comp, x, key, kp))
+			x = m_head;
+
+		for (int i = t; i >= 0; --i)
+		{
+			while (x->next[i] && step_less(x->next[i], key, kp))
+			{
+				x = x->next[i];
+				m_counters.visit(i);
+			}
+
+			path[i] = x;
+		}
+
+		return x->next[0];
+	}
+
+	template <class... Args>
+	Node* link_node(path_type& update, uint8_t height, Args&&... args)
+	{
+		Node* n = create_node(height, std::forward<Args>(args)...);
+		splice_node(update, n);
+		return n;
+	}
+
+	void splice_node(path_type& update, Node* n) noexcept
+	{
+		const uint8_t h = n->height;
+		if (h > m_level) 
+		{
+			for (size_t i = m_level; i < h; ++i) 
+				update[i] = m_head;
+
+			m_level = h;
+		}
+
+		for (size_t i = 0; i < h; ++i) 
+		{
+			n->next[i] = update[i]->next[i];
+			update[i]->next[i] = n;
+		}
+
+		++m_height_counts[h - 1];
+		++m_size;
+		++m_stamp;
+		m_counters.insert();
+	}
+
+	// Takes x out of every level it is on, x itself is left as it was.
+	void detach_node(path_type& update, Node* x) noexcept
+	{
+		for (size_t i = 0; i < x->height; ++i)
+			update[i]->next[i] = x->next[i];
+
+		--m_height_counts[x->height - 1];
+		--m_size;
+		++m_stamp;
+
+		while (m_level > 1 && m_head->next[m_level - 1] == nullptr)
+			--m_level;
+	}
+
+	Node* unlink_node(path_type& update, Node* x) noexcept
+	{
+		Node* next = x->next[0];
+		detach_node(update, x);
+		destroy_node(x);
+		m_counters.erase();
+
+		return next;
+	}
+
+	// merge() between lists that cannot share nodes.
+	void merge_by_value(SkipList& other)
+	{
+		path_type keep{};
+		keep.fill(other.m_head);
+
+		Node* s = other.m_head->next[0];
+		while (s)
+		{
+			Node* next = s->next[0];
+			if (emplace_impl(std::move(s->kv)).second)
+			{
+				other.detach_node(keep, s);
+				other.destroy_node(s);
+				other.m_counters.erase();
+			}
+			else
+			{
+				for (size_t i = 0; i < s->height; ++i)
+					keep[i] = s;
+			}
+
+			s = next;
+		}
+	}
+
+	template <class K, class M>
+	std::pair<iterator, bool> emplace_key_first(K&& key, M&& value)
+	{
+		return try_emplace_impl(std::forward<K>(key), std::forward<M>(value));
+	}
+
+	template <class K, class... Args>
+	std::pair<iterator, bool> try_emplace_impl(K&& key, Args&&... args)
+	{
+		path_type update{};
+
+		Node* x = find_path(key, update);
+		if (x && key_eq(m_comp, x->kv.first, key))
+		{
+			m_counters.insert_conflict();
+			return { iterator(x), false };
+		}
+
+		Node* n = link_node(update, random_height(key), std::piecewise_construct,
+			std::forward_as_tuple(std::forward<K>(key)),
+			std::forward_as_tuple(std::forward<Args>(args)...));
+		return { iterator(n), true };
+	}
+
+	template <class K, class M>
+	std::pair<iterator, bool> insert_or_assign_impl(K&& key, M&& value)
+	{
+		path_type update{};
+
+		Node* x = find_path(key, update);
+		if (x && key_eq(m_comp, x->kv.first, key))
+		{
+			x->kv.second = std::forward<M>(value);
+			m_counters.insert_conflict();
+			return { iterator(x), false };
+		}
+
+		Node* n = link_node(update, random_height(key), std::forward<K>(key), std::forward<M>(value));
+		return { iterator(n), true };
+	}
+
+	template <class V>
+	std::pair<iterator, bool> emplace_impl(V&& v) 
+	{
+		path_type update{};
+
+		Node* x = find_path(v.first, update);
+		if (x && key_eq(m_comp, x->kv.first, v.first))
+		{
+			m_counters.insert_conflict();
+			return { iterator(x), false };
+		}
+
+		return { iterator(link_node(update, random_height(v.first), std::forward<V>(v))), true };
+	}
+
+	template <class V>
+	std::pair<iterator, bool> emplace_impl(finger& f, V&& v)
+	{
+		Node* x = find_path(f, v.first);
+		if (x && key_eq(m_comp, x->kv.first, v.first))
+		{
+			m_counters.insert_conflict();
+			return { iterator(x), false };
+		}
+
+		Node* n = link_node(f.m_path, random_height(v.first), std::forward<V>(v));
+		f.m_stamp = m_stamp;
+		return { iterator(n), true };
+	}
+
+	template <class V>
+	std::pair<iterator, bool> erase_impl(V&& v)
+	{
+		path_type update{};
+
+		Node* x = find_path(v, update);
+		if (!x || !key_eq(m_comp, x->kv.first, v))
+		{
+			m_counters.erase_miss();
+			return { iterator(x), false };
+		}
+
+		return { iterator(unlink_node(update, x)), true };
+	}
+
+	std::pair<iterator, bool> erase_impl(finger& f, const Key& key)
+	{
+		Node* x = find_path(f, key);
+		if (!x || !key_eq(m_comp, x->kv.first, key))
+		{
+			m_counters.erase_miss();
+			return { iterator(x), false };
+		}
+
+		Node* next = unlink_node(f.m_path, x);
+		f.m_stamp = m_stamp;
+		return { iterator(next), true };
+	}
+
+private:
 	Compare		m_comp{};
 	Alloc		m_alloc{};
 	byte_alloc	m_byte_alloc{};
 	Node*		m_head = nullptr;
 	uint8_t		m_level = 1;
 	size_t		m_size = 0;
-	Uint32Dist	m_dist{ 0, Uint32Limit };
-	Random		m_rng;
+	size_t		m_stamp = 0;
+	std::array<size_t, MaxLevel> m_height_counts{};
+	[[no_unique_address]] HeightPolicy m_height{};
+	[[no_unique_address]] mutable Counters m_counters{};
 };
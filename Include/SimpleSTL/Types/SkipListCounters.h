@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+
+// Instrumentation policies for SkipList. The list reports hot path events to
+// its Counters member, NullCounters turns every hook into an empty inline call
+// and takes no space, so a default list compiles to the same code as before.
+struct NullCounters
+{
+	static constexpr bool enabled = false;
+	static constexpr int max_level = 255;
+
+	void search() const noexcept { }
+	void compare() const noexcept { }
+	void visit(int) const noexcept { }
+	void insert() const noexcept { }
+	void insert_conflict() const noexcept { }
+	void erase() const noexcept { }
+	void erase_miss() const noexcept { }
+	void allocate(size_t) const noexcept { }
+	void deallocate(size_t) const noexcept { }
+};
+
+
+// Plain per-instance counts, no atomics: a list is only ever mutated by one
+// thread at a time and reads are cheap enough to take under the same rules.
+//	search			one descent (find, lower_bound, insert, erase ...)
+//	compare			one key comparison against a node during a descent
+//	visit(level)	one step right on `level` during a descent
+//	insert_conflict	an insert that found its key already present
+//	erase_miss		an erase of a key that was not there
+template<int Levels = 32>
+struct SkipListCounters
+{
+	static constexpr bool enabled = true;
+	static constexpr int max_level = Levels;
+
+	uint64_t						searches = 0;
+	uint64_t						comparisons = 0;
+	std::array<uint64_t, Levels>	visits{};
+	uint64_t						inserts = 0;
+	uint64_t						insert_conflicts = 0;
+	uint64_t						erases = 0;
+	uint64_t						erase_misses = 0;
+	uint64_t						allocations = 0;
+	uint64_t						deallocations = 0;
+	uint64_t						bytes_allocated = 0;
+
+	void search() noexcept { ++searches; }
+	void compare() noexcept { ++comparisons; }
+	void visit(int level) noexcept { ++visits[level]; }
+	void insert() noexcept { ++inserts; }
+	void insert_conflict() noexcept { ++insert_conflicts; }
+	void erase() noexcept { ++erases; }
+	void erase_miss() noexcept { ++erase_misses; }
+	void allocate(size_t bytes) noexcept { ++allocations; bytes_allocated += bytes; }
+	void deallocate(size_t) noexcept { ++deallocations; }
+
+	uint64_t total_visits() const noexcept
+	{
+		uint64_t total = 0;
+		for (uint64_t v : visits)
+			total += v;
+		return total;
+	}
+
+	double comparisons_per_search() const noexcept
+	{
+		return searches ? (double)comparisons / searches : 0.0;
+	}
+
+	double visits_per_search() const noexcept
+	{
+		return searches ? (double)total_visits() / searches : 0.0;
+	}
+
+	void reset() noexcept { *this = SkipListCounters{}; }
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <random>
+#include <type_traits>
+
+
+// Tower height policies for SkipList. A policy provides
+//
+//	template<int MaxLevel, int PNumerator, int PDenominator, class K>
+//	uint8_t height(const K& key);
+//
+// returning a height in [1, MaxLevel] where every extra level has probability
+// PNumerator / PDenominator, and `uses_key` telling whether the key matters.
+
+namespace SkipListHeightDetail
+{
+	inline uint64_t splitmix64(uint64_t x) noexcept
+	{
+		x += 0x9E3779B97F4A7C15ull;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+		return x ^ (x >> 31);
+	}
+
+	// Turns random bits into a height. For P = 1/2^k the height comes from a
+	// single draw: every level needs k more leading zero bits. Other P values
+	// spend one draw per level.
+	template<int MaxLevel, int PNumerator, int PDenominator, class Next>
+	uint8_t height_from_bits(uint64_t r, Next&& next) noexcept
+	{
+		if constexpr (PNumerator == 1 && std::has_single_bit((unsigned)PDenominator)
+			&& std::countr_zero((unsigned)PDenominator) * (MaxLevel - 1) <= 64)
+		{
+			constexpr int bits = std::countr_zero((unsigned)PDenominator);
+			const int h = 1 + std::countl_zero(r) / bits;
+			return (uint8_t)(h < MaxLevel ? h : MaxLevel);
+		}
+		else
+		{
+			uint8_t h = 1;
+			while (h < MaxLevel && (uint32_t)(r >> 32) % PDenominator < PNumerator)
+			{
+				++h;
+				r = next();
+			}
+			return h;
+		}
+	}
+}
+
+
+// What SkipList used originally: std::mt19937 seeded from std::random_device,
+// one draw and a modulo per level.
+class MersenneHeight
+{
+public:
+	static constexpr bool uses_key = false;
+
+	MersenneHeight()
+		:	m_rng(std::random_device{}()) { }
+
+	template<int MaxLevel, int PNumerator, int PDenominator, class K>
+	uint8_t height(const K&)
+	{
+		uint8_t h = 1;
+		while (h < MaxLevel)
+		{
+			uint32_t r = m_dist(m_rng);
+			if ((r % PDenominator) >= PNumerator)
+				break;
+
+			++h;
+		}
+		return h;
+	}
+
+private:
+	std::mt19937 m_rng;
+	std::uniform_int_distribution<uint32_t> m_dist{ 0, std::numeric_limits<uint32_t>::max() };
+};
+
+
+// xorshift64* generator, height usually from one draw. Seeds are derived from
+// a process wide counter instead of std::random_device, so constructing a list
+// costs no syscall.
+class XorShiftHeight
+{
+public:
+	static constexpr bool uses_key = false;
+
+	XorShiftHeight() noexcept
+		:	XorShiftHeight(SkipListHeightDetail::splitmix64(s_instances.fetch_add(1, std::memory_order_relaxed)
+				^ reinterpret_cast<uintptr_t>(this))) { }
+
+	explicit XorShiftHeight(uint64_t seed) noexcept
+		:	m_state(SkipListHeightDetail::splitmix64(seed) | 1) { }
+
+	template<int MaxLevel, int PNumerator, int PDenominator, class K>
+	uint8_t height(const K&) noexcept
+	{
+		return SkipListHeightDetail::height_from_bits<MaxLevel, PNumerator, PDenominator>(next(), [this] { return next(); });
+	}
+
+private:
+	uint64_t next() noexcept
+	{
+		m_state ^= m_state >> 12;
+		m_state ^= m_state << 25;
+		m_state ^= m_state >> 27;
+		return m_state * 0x2545F4914F6CDD1Dull;
+	}
+
+	static inline std::atomic<uint64_t> s_instances{ 0 };
+
+	uint64_t m_state;
+};
+
+
+// Same generator with a fixed seed, every list built from the same sequence of
+// operations gets the same towers. Meant for reproducible benchmarks and tests.
+template<uint64_t Seed = 0x5EED>
+class SeededHeight : public XorShiftHeight
+{
+public:
+	SeededHeight() noexcept
+		:	XorShiftHeight(Seed) { }
+};
+
+
+// Height derived from a hash of the key: a key gets the same tower in every
+// list and on every run, with no generator state at all.
+template<class Hash = void>
+class KeyHashHeight
+{
+public:
+	static constexpr bool uses_key = true;
+
+	template<int MaxLevel, int PNumerator, int PDenominator, class K>
+	uint8_t height(const K& key) const noexcept
+	{
+		using hasher = std::conditional_t<std::is_void_v<Hash>, std::hash<std::remove_cvref_t<K>>, Hash>;
+
+		uint64_t r = SkipListHeightDetail::splitmix64(hasher{}(key));
+		return SkipListHeightDetail::height_from_bits<MaxLevel, PNumerator, PDenominator>(r,
+			[&r] { return r = SkipListHeightDetail::splitmix64(r); });
+	}
+};
@@ -0,0 +1,691 @@
+#pragma once
+
+#include <SimpleSTL/Types/SkipListHeight.h>
+
+#include <cassert>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+// Nodes keep their elements as pair<Key, Value> so they can be moved around
+// inside the node array, the iterator hands them out as a pair of references
+// with a const key.
+template<class NodePtr, class KeyRef, class ValueRef>
+class UnrolledSkipListIterator
+{
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = std::pair<std::remove_reference_t<KeyRef>, std::remove_cvref_t<ValueRef>>;
+	using difference_type = std::ptrdiff_t;
+	using reference = std::pair<KeyRef, ValueRef>;
+
+	struct pointer
+	{
+		reference ref;
+		const reference* operator->() const noexcept { return &ref; }
+	};
+
+	UnrolledSkipListIterator() noexcept = default;
+	UnrolledSkipListIterator(NodePtr n, uint8_t index) noexcept
+		:	m_node(n), m_index(index) { }
+
+	reference operator*() const noexcept
+	{
+		auto& slot = m_node->data()[m_index];
+		return reference(slot.first, slot.second);
+	}
+	pointer operator->() const noexcept { return pointer{ **this }; }
+
+	UnrolledSkipListIterator& operator++() noexcept
+	{
+		if (++m_index == m_node->count)
+		{
+			m_node = m_node->next[0];
+			m_index = 0;
+		}
+		return *this;
+	}
+	UnrolledSkipListIterator operator++(int) noexcept
+	{
+		UnrolledSkipListIterator tmp(*this);
+		++(*this);
+		return tmp;
+	}
+
+	friend bool operator==(const UnrolledSkipListIterator& a, const UnrolledSkipListIterator& b) noexcept
+	{
+		return a.m_node == b.m_node && a.m_index == b.m_index;
+	}
+	friend bool operator!=(const UnrolledSkipListIterator& a, const UnrolledSkipListIterator& b) noexcept
+	{
+		return !(a == b);
+	}
+
+	NodePtr node() const noexcept { return m_node; }
+	uint8_t index() const noexcept { return m_index; }
+
+private:
+	NodePtr m_node = nullptr;
+	uint8_t m_index = 0;
+};
+
+
+// Elements per node: as many as fit in two cache lines, but at least 4.
+template<class Key, class Value>
+inline constexpr int unrolled_node_capacity = std::clamp<int>((int)(128 / sizeof(std::pair<const Key, Value>)), 4, 64);
+
+
+// Skip list whose nodes hold a small sorted array of elements instead of a
+// single one. The towers index the smallest key of every node, so a search
+// makes one pointer hop per node and finishes with a scan inside it. Full
+// nodes split in half on insert, a node that drops under half full after an
+// erase absorbs its successor when both fit in one node.
+template<
+	class Key,
+	class Value,
+	class Compare = std::less<Key>,
+	class Alloc = std::allocator<std::pair<const Key, Value>>,
+	int MaxLevel = 12,
+	int PNumerator = 1,
+	int PDenominator = 4,
+	class HeightPolicy = XorShiftHeight,
+	int Capacity = unrolled_node_capacity<Key, Value>
+>
+class UnrolledSkipList
+{
+private:
+	static_assert(MaxLevel >= 2, "Max level must be more or equal than 2");
+	static_assert(PNumerator > 0 && PDenominator > 0 && PNumerator < PDenominator, "P must be 0 < P < 1");
+	static_assert(Capacity >= 2 && Capacity <= 255, "Capacity must be in [2, 255]");
+	static_assert(std::is_nothrow_move_constructible_v<Key> && std::is_nothrow_move_constructible_v<Value>,
+		"Key and Value must be nothrow move constructible, nodes shift their elements on insert and erase");
+
+public:
+	using key_type = Key;
+	using mapped_type = Value;
+	using value_type = std::pair<const Key, Value>;
+	using size_type = size_t;
+	using diff_type = std::ptrdiff_t;
+	using key_compare = Compare;
+	using allocator_type = Alloc;
+
+	static constexpr int node_capacity = Capacity;
+
+private:
+	using slot_type = std::pair<Key, Value>;
+	using byte_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::byte>;
+	using byte_traits = std::allocator_traits<byte_alloc>;
+
+	struct Node
+	{
+		uint8_t height = 1;
+		uint8_t count = 0;
+		alignas(slot_type) std::byte storage[Capacity * sizeof(slot_type)];
+		Node* next[1];
+
+		explicit Node(uint8_t h) noexcept
+			: height(h) { }
+
+		~Node()
+		{
+			for (uint8_t i = 0; i < count; ++i)
+				data()[i].~slot_type();
+		}
+
+		slot_type* data() noexcept { return std::launder(reinterpret_cast<slot_type*>(storage)); }
+		const slot_type* data() const noexcept { return std::launder(reinterpret_cast<const slot_type*>(storage)); }
+
+		const Key& min_key() const noexcept { return data()[0].first; }
+	};
+
+	static constexpr size_t node_bytes(uint8_t height) noexcept
+	{
+		return sizeof(Node) + (static_cast<size_t>(height) - 1) * sizeof(Node*);
+	}
+
+	using path_type = std::array<Node*, MaxLevel>;
+
+	Node* create_node(uint8_t height)
+	{
+		assert(height >= 1 && height <= MaxLevel);
+
+		std::byte* memory = byte_traits::allocate(m_byte_alloc, node_bytes(height));
+
+		Node* n = ::new (static_cast<void*>(memory)) Node(height);
+		for (size_t i = 0; i < height; ++i)
+		{
+			n->next[i] = nullptr;
+		}
+
+		return n;
+	}
+
+	void destroy_node(Node* n) noexcept
+	{
+		if (!n)
+			return;
+
+		const size_t bytes = node_bytes(n->height);
+		auto* memory = reinterpret_cast<std::byte*>(n);
+
+		n->~Node();
+		byte_traits::deallocate(m_byte_alloc, memory, bytes);
+	}
+
+	// Moves *src into the raw slot dst and ends the lifetime of *src.
+	static void relocate(slot_type* dst, slot_type* src) noexcept
+	{
+		::new (static_cast<void*>(dst)) slot_type(std::move(*src));
+		src->~slot_type();
+	}
+
+	template<class A, class B>
+	static constexpr bool key_less(const Compare& comp, const A& a, const B& b)
+	{
+		return comp(a, b);
+	}
+
+	template<class A, class B>
+	static constexpr bool key_eq(const Compare& comp, const A& a, const B& b)
+	{
+		return !comp(a, b) && !comp(b, a);
+	}
+
+public:
+	using iterator = UnrolledSkipListIterator<Node*, const Key&, Value&>;
+	using const_iterator = UnrolledSkipListIterator<const Node*, const Key&, const Value&>;
+
+	UnrolledSkipList()
+		: UnrolledSkipList(Compare{}, Alloc{}) { }
+
+	explicit UnrolledSkipList(const Compare& comp, const Alloc& alloc = Alloc{})
+		: m_comp(comp), m_alloc(alloc), m_byte_alloc(alloc)
+	{
+		ini_head();
+	}
+
+	UnrolledSkipList(const UnrolledSkipList& other)
+		: m_comp(other.m_comp),
+		m_alloc(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.m_alloc)),
+		m_byte_alloc(m_alloc)
+	{
+		ini_head();
+		for (const auto& kv : other)
+			insert(kv);
+	}
+
+	UnrolledSkipList& operator=(const UnrolledSkipList& other)
+	{
+		if (this == &other)
+			return *this;
+
+		clear();
+		if constexpr (std::allocator_traits<Alloc>::propagate_on_container_copy_assignment::value)
+		{
+			m_alloc = other.m_alloc;
+			m_byte_alloc = byte_alloc(m_alloc);
+		}
+		m_comp = other.m_comp;
+
+		for (const auto& kv : other)
+			insert(kv);
+
+		return *this;
+	}
+
+	UnrolledSkipList(UnrolledSkipList&& other) noexcept
+		: m_comp(std::move(other.m_comp)),
+		m_alloc(std::move(other.m_alloc)),
+		m_byte_alloc(std::move(other.m_byte_alloc)),
+		m_head(other.m_head),
+		m_level(other.m_level),
+		m_size(other.m_size),
+		m_nodes(other.m_nodes),
+		m_height(std::move(other.m_height))
+	{
+		other.m_head = nullptr;
+		other.m_level = 1;
+		other.m_size = 0;
+		other.m_nodes = 0;
+	}
+
+	UnrolledSkipList& operator=(UnrolledSkipList&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		clear();
+		destroy_node(m_head);
+
+		if constexpr (std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value)
+		{
+			m_alloc = std::move(other.m_alloc);
+			m_byte_alloc = std::move(other.m_byte_alloc);
+		}
+
+		m_comp = std::move(other.m_comp);
+		m_head = other.m_head;
+		m_level = other.m_level;
+		m_size = other.m_size;
+		m_nodes = other.m_nodes;
+		m_height = std::move(other.m_height);
+
+		other.m_head = nullptr;
+		other.m_level = 1;
+		other.m_size = 0;
+		other.m_nodes = 0;
+		return *this;
+	}
+
+	~UnrolledSkipList()
+	{
+		clear();
+		destroy_node(m_head);
+		m_head = nullptr;
+	}
+
+	allocator_type get_allocator() const noexcept { return m_alloc; }
+	key_compare key_comp() const { return m_comp; }
+
+	bool empty() const noexcept { return m_size == 0; }
+	size_type size() const noexcept { return m_size; }
+
+	// Number of nodes, size() / node_count() is the average fill.
+	size_type node_count() const noexcept { return m_nodes; }
+
+	iterator begin() noexcept { return iterator(m_head->next[0], 0); }
+	iterator end() noexcept { return iterator(nullptr, 0); }
+	const_iterator begin() const noexcept { return const_iterator(m_head->next[0], 0); }
+	const_iterator end() const noexcept { return const_iterator(nullptr, 0); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+
+	void clear() noexcept
+	{
+		if (!m_head)
+			return;
+
+		Node* cur = m_head->next[0];
+		while (cur)
+		{
+			Node* nxt = cur->next[0];
+			destroy_node(cur);
+			cur = nxt;
+		}
+
+		for (std::size_t i = 0; i < MaxLevel; ++i)
+			m_head->next[i] = nullptr;
+
+		m_level = 1;
+		m_size = 0;
+		m_nodes = 0;
+	}
+
+	std::pair<iterator, bool> insert(const value_type& v) { return emplace_impl(v.first, v); }
+	std::pair<iterator, bool> insert(value_type&& v) { return emplace_impl(v.first, std::move(v)); }
+
+	template<class... Args>
+	std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args)
+	{
+		return emplace_impl(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+	}
+
+	template<class M>
+	std::pair<iterator, bool> insert_or_assign(const Key& key, M&& value)
+	{
+		auto res = emplace_impl(key, key, std::forward<M>(value));
+		if (!res.second)
+			res.first->second = std::forward<M>(value);
+
+		return res;
+	}
+
+	std::pair<iterator, bool> insert_or_assign(const Key& key, const Value& value) { return insert_or_assign<const Value&>(key, value); }
+	std::pair<iterator, bool> insert_or_assign(const Key& key, Value&& value) { return insert_or_assign<Value>(key, std::move(value)); }
+
+	std::pair<iterator, bool> erase(const Key& key) { return erase_impl(key); }
+
+	iterator erase(iterator pos)
+	{
+		if (pos == end())
+			return end();
+
+		auto [it, erased] = erase_impl(pos->first);
+		return it;
+	}
+
+	iterator find(const Key& key) noexcept
+	{
+		auto [n, i] = find_ge(key);
+		if (n && key_eq(m_comp, n->data()[i].first, key))
+			return iterator(n, i);
+
+		return end();
+	}
+	const_iterator find(const Key& key) const noexcept
+	{
+		auto [n, i] = find_ge(key);
+		if (n && key_eq(m_comp, n->data()[i].first, key))
+			return const_iterator(n, i);
+
+		return end();
+	}
+
+	bool contains(const Key& key) const noexcept
+	{
+		return find(key) != end();
+	}
+
+	iterator lower_bound(const Key& key) noexcept
+	{
+		auto [n, i] = find_ge(key);
+		return iterator(n, i);
+	}
+	const_iterator lower_bound(const Key& key) const noexcept
+	{
+		auto [n, i] = find_ge(key);
+		return const_iterator(n, i);
+	}
+
+private:
+	void ini_head()
+	{
+		m_head = create_node((uint8_t)(MaxLevel));
+		m_level = 1;
+		m_size = 0;
+		m_nodes = 0;
+	}
+
+	template<class K>
+	uint8_t random_height(const K& key)
+	{
+		return m_height.template height<MaxLevel, PNumerator, PDenominator>(key);
+	}
+
+	// Index of the first element of n not less than key, n->count if none.
+	// Small nodes are scanned linearly, larger ones binary searched.
+	uint8_t node_lower_bound(const Node* n, const Key& key) const noexcept
+	{
+		const slot_type* d = n->data();
+		if constexpr (Capacity <= 8)
+		{
+			uint8_t i = 0;
+			while (i < n->count && key_less(m_comp, d[i].first, key))
+				++i;
+
+			return i;
+		}
+		else
+		{
+			const slot_type* it = std::partition_point(d, d + n->count,
+				[&](const slot_type& kv) { return key_less(m_comp, kv.first, key); });
+			return (uint8_t)(it - d);
+		}
+	}
+
+	// Fills update[i] with the last node on level i whose smallest key is less
+	// than `key` and returns update[0]. Only that node can hold elements less
+	// than `key` that sit right before it.
+	Node* find_path(const Key& key, path_type& update) const noexcept
+	{
+		Node* x = m_head;
+		for (int i = (int)(m_level) - 1; i >= 0; --i)
+		{
+			while (x->next[i] && key_less(m_comp, x->next[i]->min_key(), key))
+				x = x->next[i];
+
+			update[i] = x;
+		}
+
+		return x;
+	}
+
+	std::pair<Node*, uint8_t> find_ge(const Key& key) const noexcept
+	{
+		Node* x = m_head;
+		for (int i = (int)(m_level) - 1; i >= 0; --i)
+		{
+			while (x->next[i] && key_less(m_comp, x->next[i]->min_key(), key))
+				x = x->next[i];
+		}
+
+		if (x != m_head)
+		{
+			const uint8_t i = node_lower_bound(x, key);
+			if (i < x->count)
+				return { x, i };
+		}
+
+		return { x->next[0], 0 };
+	}
+
+	template<class... Args>
+	void node_insert(Node* n, uint8_t pos, Args&&... args)
+	{
+		slot_type* d = n->data();
+		for (uint8_t i = n->count; i > pos; --i)
+			relocate(d + i, d + i - 1);
+
+		try
+		{
+			::new (static_cast<void*>(d + pos)) slot_type(std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			for (uint8_t i = pos; i < n->count; ++i)
+				relocate(d + i, d + i + 1);
+			throw;
+		}
+
+		++n->count;
+	}
+
+	void node_erase(Node* n, uint8_t pos) noexcept
+	{
+		slot_type* d = n->data();
+		d[pos].~slot_type();
+		for (uint8_t i = pos + 1; i < n->count; ++i)
+			relocate(d + i - 1, d + i);
+
+		--n->count;
+	}
+
+	void splice_node(path_type& pred, Node* n) noexcept
+	{
+		const uint8_t h = n->height;
+		if (h > m_level)
+		{
+			for (size_t i = m_level; i < h; ++i)
+				pred[i] = m_head;
+
+			m_level = h;
+		}
+
+		for (size_t i = 0; i < h; ++i)
+		{
+			n->next[i] = pred[i]->next[i];
+			pred[i]->next[i] = n;
+		}
+
+		++m_nodes;
+	}
+
+	void unlink_node(path_type& pred, Node* x) noexcept
+	{
+		for (size_t i = 0; i < x->height; ++i)
+			pred[i]->next[i] = x->next[i];
+
+		destroy_node(x);
+		--m_nodes;
+
+		while (m_level > 1 && m_head->next[m_level - 1] == nullptr)
+			--m_level;
+	}
+
+	// Predecessors of the node right after n: n itself on the levels it
+	// reaches, the search path above them. `update` must be a path for a key
+	// that lies in n or before its successor.
+	path_type successor_path(Node* n, const path_type& update) const noexcept
+	{
+		path_type pred{};
+		for (size_t i = 0; i < m_level; ++i)
+			pred[i] = i < n->height ? n : update[i];
+
+		return pred;
+	}
+
+	// Moves the upper half of a full node into a new node linked after it.
+	Node* split_node(Node* n, const path_type& update)
+	{
+		const uint8_t half = n->count / 2;
+		Node* s = create_node(random_height(n->data()[half].first));
+
+		slot_type* from = n->data();
+		slot_type* to = s->data();
+		for (uint8_t i = half; i < n->count; ++i)
+			relocate(to + (i - half), from + i);
+
+		s->count = n->count - half;
+		n->count = half;
+
+		path_type pred = successor_path(n, update);
+		splice_node(pred, s);
+		return s;
+	}
+
+	template<class... Args>
+	std::pair<iterator, bool> emplace_impl(const Key& key, Args&&... args)
+	{
+		path_type update{};
+
+		Node* x = find_path(key, update);
+		Node* nx = x->next[0];
+		if (nx && !key_less(m_comp, key, nx->min_key()))
+			return { iterator(nx, 0), false };
+
+		if (x == m_head && !nx)
+		{
+			Node* n = create_node(random_height(key));
+			try
+			{
+				node_insert(n, 0, std::forward<Args>(args)...);
+			}
+			catch (...)
+			{
+				destroy_node(n);
+				throw;
+			}
+
+			splice_node(update, n);
+			++m_size;
+			return { iterator(n, 0), true };
+		}
+
+		// keys before the first node go to the front of that node
+		Node* target = x;
+		uint8_t pos = 0;
+		if (x == m_head)
+		{
+			target = nx;
+		}
+		else
+		{
+			pos = node_lower_bound(x, key);
+			if (pos < x->count && key_eq(m_comp, x->data()[pos].first, key))
+				return { iterator(x, pos), false };
+		}
+
+		if (target->count == Capacity)
+		{
+			Node* s = split_node(target, update);
+			if (pos > target->count)
+			{
+				pos -= target->count;
+				target = s;
+			}
+		}
+
+		node_insert(target, pos, std::forward<Args>(args)...);
+		++m_size;
+		return { iterator(target, pos), true };
+	}
+
+	std::pair<iterator, bool> erase_impl(const Key& key)
+	{
+		path_type update{};
+
+		Node* x = find_path(key, update);
+		Node* nx = x->next[0];
+
+		Node* target = nullptr;
+		uint8_t pos = 0;
+		if (nx && !key_less(m_comp, key, nx->min_key()))
+		{
+			target = nx;
+		}
+		else if (x != m_head)
+		{
+			pos = node_lower_bound(x, key);
+			if (pos == x->count)
+				return { iterator(nx, 0), false };
+			if (!key_eq(m_comp, x->data()[pos].first, key))
+				return { iterator(x, pos), false };
+
+			target = x;
+		}
+		else
+		{
+			return { iterator(nx, 0), false };
+		}
+
+		node_erase(target, pos);
+		--m_size;
+
+		// only a node whose smallest key was erased can run empty, update
+		// then holds its predecessors
+		if (target->count == 0)
+		{
+			Node* next = target->next[0];
+			unlink_node(update, target);
+			return { iterator(next, 0), true };
+		}
+
+		Node* next = target->next[0];
+		if (next && target->count < Capacity / 2 && target->count + next->count <= Capacity)
+		{
+			slot_type* to = target->data();
+			slot_type* from = next->data();
+			for (uint8_t i = 0; i < next->count; ++i)
+				relocate(to + target->count + i, from + i);
+
+			target->count += next->count;
+			next->count = 0;
+
+			path_type pred = successor_path(target, update);
+			unlink_node(pred, next);
+		}
+
+		if (pos == target->count)
+			return { iterator(target->next[0], 0), true };
+
+		return { iterator(target, pos), true };
+	}
+
+private:
+	Compare		m_comp{};
+	Alloc		m_alloc{};
+	byte_alloc	m_byte_alloc{};
+	Node*		m_head = nullptr;
+	uint8_t		m_level = 1;
+	size_t		m_size = 0;
+	size_t		m_nodes = 0;
+	[[no_unique_address]] HeightPolicy m_height{};
+};
@@ -0,0 +1,297 @@
+#pragma once
+
+#include <SimpleSTL/Types/ConcurrentSkipList.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <utility>
+
+
+template<class Key>
+struct VersionedKey
+{
+	Key			key{};
+	uint64_t	sequence = 0;
+};
+
+template<class Value>
+struct VersionedValue
+{
+	Value		value{};
+	bool		deleted = false;
+};
+
+// Orders by key ascending, then by sequence descending, so the newest
+// version of a key comes first.
+template<class Key, class Compare>
+struct VersionedKeyCompare
+{
+	Compare comp{};
+
+	bool operator()(const VersionedKey<Key>& a, const VersionedKey<Key>& b) const
+	{
+		if (comp(a.key, b.key))
+			return true;
+		if (comp(b.key, a.key))
+			return false;
+
+		return a.sequence > b.sequence;
+	}
+};
+
+
+// Multi-version memtable on top of ConcurrentSkipList. Every write appends a
+// new version tagged with the next sequence number, erase appends a
+// tombstone. A snapshot is just a sequence number: it sees, for every key, the
+// newest version not newer than itself, so taking one costs a single atomic
+// load and stays consistent while writers keep going. Old versions are never
+// reclaimed, the table is meant to be flushed and dropped as a whole.
+//
+// Writers may run concurrently with each other and with readers. Sequence
+// numbers are handed out at the start of a write but published in order, so
+// a snapshot never sees a version while an older one is still being linked.
+template<
+	class Key,
+	class Value,
+	class Compare = std::less<Key>,
+	class Alloc = std::allocator<std::pair<const Key, Value>>,
+	int MaxLevel = 12,
+	int PNumerator = 1,
+	int PDenominator = 4
+>
+class VersionedSkipList
+{
+public:
+	using key_type = Key;
+	using mapped_type = Value;
+	using size_type = size_t;
+	using key_compare = Compare;
+	using sequence_type = uint64_t;
+
+private:
+	using version_key = VersionedKey<Key>;
+	using version_value = VersionedValue<Value>;
+	using version_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<std::pair<const version_key, version_value>>;
+	using list_type = ConcurrentSkipList<version_key, version_value, VersionedKeyCompare<Key, Compare>, version_alloc, MaxLevel, PNumerator, PDenominator>;
+	using list_iterator = typename list_type::const_iterator;
+
+public:
+	// Iterates the newest visible version of every live key in key order.
+	class const_iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = std::pair<const Key&, const Value&>;
+		using difference_type = std::ptrdiff_t;
+		using reference = value_type;
+
+		struct pointer
+		{
+			value_type pair;
+			const value_type* operator->() const noexcept { return &pair; }
+		};
+
+		const_iterator() noexcept = default;
+
+		reference operator*() const noexcept { return { m_it->first.key, m_it->second.value }; }
+		pointer operator->() const noexcept { return { **this }; }
+
+		const Key& key() const noexcept { return m_it->first.key; }
+		const Value& value() const noexcept { return m_it->second.value; }
+		sequence_type sequence() const noexcept { return m_it->first.sequence; }
+
+		const_iterator& operator++()
+		{
+			const Key& current = m_it->first.key;
+			++m_it;
+			while (m_it != list_iterator() && !m_owner->key_less(current, m_it->first.key))
+				++m_it;
+
+			settle();
+			return *this;
+		}
+		const_iterator operator++(int)
+		{
+			const_iterator tmp(*this);
+			++(*this);
+			return tmp;
+		}
+
+		friend bool operator==(const const_iterator& a, const const_iterator& b) noexcept
+		{
+			return a.m_it == b.m_it;
+		}
+		friend bool operator!=(const const_iterator& a, const const_iterator& b) noexcept
+		{
+			return !(a == b);
+		}
+
+	private:
+		friend class VersionedSkipList;
+
+		const_iterator(const VersionedSkipList* owner, list_iterator it, sequence_type seq)
+			: m_owner(owner), m_it(it), m_seq(seq)
+		{
+			settle();
+		}
+
+		// Moves to the first entry that is the newest visible version of its
+		// key and not a tombstone.
+		void settle()
+		{
+			while (m_it != list_iterator())
+			{
+				if (m_it->first.sequence > m_seq)
+				{
+					++m_it;
+					continue;
+				}
+
+				if (!m_it->second.deleted)
+					return;
+
+				const Key& dead = m_it->first.key;
+				++m_it;
+				while (m_it != list_iterator() && !m_owner->key_less(dead, m_it->first.key))
+					++m_it;
+			}
+		}
+
+		const VersionedSkipList* m_owner = nullptr;
+		list_iterator m_it{};
+		sequence_type m_seq = 0;
+	};
+
+	// Point in time view. Cheap to copy, must not outlive the list.
+	class snapshot_handle
+	{
+	public:
+		snapshot_handle() noexcept = default;
+
+		sequence_type sequence() const noexcept { return m_seq; }
+
+		const_iterator begin() const { return const_iterator(m_owner, m_owner->m_list.begin(), m_seq); }
+		const_iterator end() const { return const_iterator(); }
+
+		const_iterator find(const Key& key) const
+		{
+			const_iterator it = lower_bound(key);
+			if (it != end() && !m_owner->key_less(key, it.key()))
+				return it;
+
+			return end();
+		}
+
+		bool contains(const Key& key) const
+		{
+			return find(key) != end();
+		}
+
+		const_iterator lower_bound(const Key& key) const
+		{
+			return const_iterator(m_owner, m_owner->m_list.lower_bound(version_key{ key, m_seq }), m_seq);
+		}
+
+	private:
+		friend class VersionedSkipList;
+
+		snapshot_handle(const VersionedSkipList* owner, sequence_type seq) noexcept
+			: m_owner(owner), m_seq(seq) { }
+
+		const VersionedSkipList* m_owner = nullptr;
+		sequence_type m_seq = 0;
+	};
+
+	VersionedSkipList()
+		: VersionedSkipList(Compare{}, Alloc{}) { }
+
+	explicit VersionedSkipList(const Compare& comp, const Alloc& alloc = Alloc{})
+		: m_comp(comp), m_list(VersionedKeyCompare<Key, Compare>{ comp }, version_alloc(alloc)) { }
+
+	VersionedSkipList(const VersionedSkipList&) = delete;
+	VersionedSkipList& operator=(const VersionedSkipList&) = delete;
+
+	key_compare key_comp() const { return m_comp; }
+
+	// Number of stored versions, tombstones included.
+	size_type version_count() const noexcept { return m_list.size(); }
+
+	// Sequence number of the newest published write.
+	sequence_type sequence() const noexcept { return m_visible.load(std::memory_order_acquire); }
+
+	snapshot_handle snapshot() const noexcept { return snapshot_handle(this, sequence()); }
+
+	// Reads at the newest published sequence.
+	const_iterator begin() const { return snapshot().begin(); }
+	const_iterator end() const { return const_iterator(); }
+	const_iterator find(const Key& key) const { return snapshot().find(key); }
+	bool contains(const Key& key) const { return snapshot().contains(key); }
+	const_iterator lower_bound(const Key& key) const { return snapshot().lower_bound(key); }
+
+	// Both return the sequence number the write was published under.
+	template<class K, class V>
+	sequence_type insert_or_assign(K&& key, V&& value)
+	{
+		return write(std::forward<K>(key), version_value{ std::forward<V>(value), false });
+	}
+
+	template<class K>
+	sequence_type erase(K&& key)
+	{
+		return write(std::forward<K>(key), version_value{ Value{}, true });
+	}
+
+	// Not thread-safe, no other operation may run concurrently.
+	void clear() noexcept
+	{
+		m_list.clear();
+		m_next.store(0, std::memory_order_relaxed);
+		m_visible.store(0, std::memory_order_relaxed);
+	}
+
+private:
+	bool key_less(const Key& a, const Key& b) const
+	{
+		return m_comp(a, b);
+	}
+
+	template<class K>
+	sequence_type write(K&& key, version_value&& value)
+	{
+		const sequence_type seq = m_next.fetch_add(1, std::memory_order_relaxed) + 1;
+
+		try
+		{
+			m_list.insert({ version_key{ std::forward<K>(key), seq }, std::move(value) });
+		}
+		catch (...)
+		{
+			publish(seq);
+			throw;
+		}
+
+		publish(seq);
+		return seq;
+	}
+
+	// Waits for every older write to publish first, so the visible sequence
+	// only ever covers versions that are fully linked.
+	void publish(sequence_type seq) noexcept
+	{
+		while (m_visible.load(std::memory_order_acquire) != seq - 1)
+			std::this_thread::yield();
+
+		m_visible.store(seq, std::memory_order_release);
+	}
+
+private:
+	Compare						m_comp{};
+	list_type					m_list;
+	std::atomic<sequence_type>	m_next{ 0 };
+	std::atomic<sequence_type>	m_visible{ 0 };
+};